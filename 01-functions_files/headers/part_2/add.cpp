@@ -1,5 +1,7 @@
 #include "add.h"
+#include "../../../common/checked.h"
 
+// Clamps at INT_MAX / INT_MIN instead of overflowing (which is UB for int)
 int add(int x, int y) {
-  return x + y;
+  return Checked::add<Checked::Saturate>(x, y);
 }
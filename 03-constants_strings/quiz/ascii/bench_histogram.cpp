@@ -0,0 +1,119 @@
+// +--------------------------------------------+
+// |          BYTE HISTOGRAM THROUGHPUT         |
+// +--------------------------------------------+
+//
+// g++ -std=c++20 -O2 -pthread histogram.cpp bench_histogram.cpp -o bench_histogram
+// ./bench_histogram [megabytes] [threads]   (defaults: 512 MiB, every hardware thread)
+//
+// Three inputs: log-like text, uniformly random bytes, and a single byte
+// repeated (the worst case for one histogram, since every increment waits
+// for the previous one). Each is counted with ++counts[byte], with the
+// eight sub-histograms, and with the sub-histograms on 1, 2, 4, ... threads.
+// Finally the text is written to a temporary file and counted through
+// countFile (mmap), as ascii_code stats does; the file is in the page
+// cache by then, so this measures the mapping, not the disk.
+
+#include "histogram.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <unistd.h>
+
+namespace {
+  template <typename F>
+  double bestSeconds(F&& f) {
+    double best { 1e30 };
+
+    for (int rep { 0 }; rep < 3; ++rep) {
+      auto start { std::chrono::steady_clock::now() };
+      f();
+      best = std::min(best, std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+    }
+
+    return best;
+  }
+
+  std::vector<std::uint8_t> makeText(std::size_t bytes, std::mt19937_64& rng) {
+    std::vector<std::uint8_t> text(bytes);
+
+    for (std::size_t i { 0 }; i < bytes; ++i) {
+      const auto r { rng() % 64 };
+      text[i] = r < 2 ? '\n' : r < 10 ? ' ' : r < 18 ? static_cast<std::uint8_t>('0' + r % 10) : r < 20 ? ':' : static_cast<std::uint8_t>('a' + r % 26);
+    }
+
+    return text;
+  }
+
+  void report(const char* method, std::size_t bytes, double seconds, bool same) {
+    std::cout << "  " << method << bytes / seconds / 1e9 << " GB/s" << (same ? "\n" : "  [MISMATCH]\n");
+  }
+
+  void benchInput(const char* name, const std::vector<std::uint8_t>& input, unsigned threads) {
+    std::cout << name << '\n';
+
+    Ascii::ByteStats reference { }, stats { };
+    const double scalar { bestSeconds([&] { reference = Ascii::countBytesScalar(input); }) };
+    report("++counts[byte]:           ", input.size(), scalar, true);
+
+    const double sub { bestSeconds([&] { stats = Ascii::countBytes(input); }) };
+    report("8 sub-histograms:         ", input.size(), sub, stats.counts == reference.counts);
+
+    for (unsigned t { 1 }; t <= threads; t *= 2) {
+      const double parallel { bestSeconds([&] { stats = Ascii::countBytesParallel(input, t); }) };
+      const std::string label { "8 sub-histograms, " + std::to_string(t) + " thr:  " };
+      report(label.c_str(), input.size(), parallel, stats.counts == reference.counts);
+    }
+  }
+}
+
+int main(int argc, char** argv) {
+  const std::size_t megabytes { argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 512ull };
+  unsigned          threads   { argc > 2 ? static_cast<unsigned>(std::strtoul(argv[2], nullptr, 10)) : 0u };
+
+  if (threads == 0)
+    threads = std::max(1u, std::thread::hardware_concurrency());
+
+  std::mt19937_64 rng { 6 };
+  const std::size_t bytes { megabytes << 20 };
+
+  const std::vector<std::uint8_t> text { makeText(bytes, rng) };
+  std::vector<std::uint8_t> random(bytes);
+  for (auto& b : random)
+    b = static_cast<std::uint8_t>(rng());
+  const std::vector<std::uint8_t> repeated(bytes, 'a');
+
+  benchInput("log-like text", text, threads);
+  benchInput("random bytes", random, threads);
+  benchInput("one byte repeated", repeated, threads);
+
+  char path[] { "/tmp/bench_histogram_XXXXXX" };
+  const int fd { mkstemp(path) };
+
+  if (fd < 0 || write(fd, text.data(), text.size()) != static_cast<ssize_t>(text.size())) {
+    std::perror("temporary file");
+    return 1;
+  }
+
+  close(fd);
+
+  Ascii::ByteStats stats { };
+  const double mapped { bestSeconds([&] { Ascii::countFile(path, stats, threads); }) };
+  report("countFile (mmap):         ", text.size(), mapped, stats.counts == Ascii::countBytesScalar(text).counts);
+  unlink(path);
+
+  std::cout << "classes of the text:";
+  const auto classes { stats.classes() };
+  for (std::size_t c { 0 }; c < Ascii::charClassCount; ++c)
+    std::cout << ' ' << Ascii::className(static_cast<Ascii::CharClass>(c)) << ' ' << classes[c];
+  std::cout << '\n';
+
+  return 0;
+}
@@ -0,0 +1,89 @@
+// +--------------------------------------------+
+// |          BYTE LISTING THROUGHPUT           |
+// +--------------------------------------------+
+//
+// g++ -std=c++20 -O2 transcode.cpp bench_transcode.cpp ../../../common/radix_format.cpp -o bench_transcode
+// ./bench_transcode [megabytes]   (default: 1024, i.e. a 1 GB input)
+//
+// The input is mostly text (letters, spaces, a line break every ~60
+// bytes) with 1 byte in 32 random, so the escaped listing sees both runs
+// and escapes. It is transcoded 1 MiB at a time into one preallocated
+// output buffer, as transcodeStream does, without the system calls. The
+// per-byte baseline is what ascii_code does for one character:
+// operator<< of static_cast<int>(c), on the first 16 MiB only.
+
+#include "transcode.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <vector>
+
+namespace {
+  double secondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  }
+
+  std::vector<std::uint8_t> makeInput(std::size_t bytes) {
+    std::vector<std::uint8_t> input(bytes);
+    std::mt19937_64 rng { 4 };
+
+    for (std::size_t i { 0 }; i < bytes; i += 8) {
+      std::uint64_t r { rng() };
+
+      for (std::size_t k { 0 }; k < 8 && i + k < bytes; ++k, r >>= 8) {
+        const auto b { static_cast<std::uint8_t>(r) };
+        input[i + k] = b < 8 ? static_cast<std::uint8_t>(rng()) : b < 12 ? '\n' : b < 52 ? ' ' : static_cast<std::uint8_t>('a' + b % 26);
+      }
+    }
+
+    return input;
+  }
+
+  const char* listingName(Ascii::Listing listing) {
+    switch (listing) {
+      case Ascii::Listing::decimal: return "decimal";
+      case Ascii::Listing::hex:     return "hex    ";
+      default:                      return "escaped";
+    }
+  }
+}
+
+int main(int argc, char** argv) {
+  const std::size_t megabytes { argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1024ull };
+  constexpr std::size_t chunk { 1 << 20 };
+
+  std::cout << "generating " << megabytes << " MiB...\n";
+  const std::vector<std::uint8_t> input { makeInput(megabytes << 20) };
+  std::vector<char> output(chunk * Ascii::maxExpansion(Ascii::Listing::decimal));
+
+  for (const Ascii::Listing listing : { Ascii::Listing::decimal, Ascii::Listing::hex, Ascii::Listing::escaped }) {
+    std::size_t written { 0 };
+    const auto start { std::chrono::steady_clock::now() };
+
+    for (std::size_t at { 0 }; at < input.size(); at += chunk) {
+      const std::span<const std::uint8_t> piece { input.data() + at, std::min(chunk, input.size() - at) };
+      written += Ascii::transcode(piece, listing, output.data());
+    }
+
+    const double seconds { secondsSince(start) };
+    std::cout << listingName(listing) << "  " << input.size() / seconds / 1e9 << " GB/s in, "
+              << written / seconds / 1e9 << " GB/s out\n";
+  }
+
+  // What ascii_code does for one character, for every byte
+  const std::size_t sample { std::min<std::size_t>(input.size(), 16 << 20) };
+  std::ostringstream out { };
+  const auto start { std::chrono::steady_clock::now() };
+
+  for (std::size_t i { 0 }; i < sample; ++i)
+    out << std::setw(3) << static_cast<int>(input[i]) << ((i + 1) % 16 == 0 ? '\n' : ' ');
+
+  std::cout << "ostream decimal  " << sample / secondsSince(start) / 1e9 << " GB/s in\n";
+
+  return 0;
+}
@@ -0,0 +1,185 @@
+#include "histogram.h"
+
+#include <algorithm>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace Ascii {
+  namespace {
+    // Consecutive bytes go to different tables, so equal bytes in a row do
+    // not wait for each other's increment
+    constexpr std::size_t subHistograms { 8 };
+
+    // Bytes per round of 32-bit counting; a counter sees at most an eighth
+    constexpr std::size_t roundBytes { std::size_t { 1 } << 32 };
+
+    using SubHistograms = std::array<std::array<std::uint32_t, 256>, subHistograms>;
+
+    void countWord(SubHistograms& tables, std::uint64_t word) {
+      ++tables[0][word       & 0xFF];
+      ++tables[1][word >> 8  & 0xFF];
+      ++tables[2][word >> 16 & 0xFF];
+      ++tables[3][word >> 24 & 0xFF];
+      ++tables[4][word >> 32 & 0xFF];
+      ++tables[5][word >> 40 & 0xFF];
+      ++tables[6][word >> 48 & 0xFF];
+      ++tables[7][word >> 56];
+    }
+
+    void countRound(const std::uint8_t* bytes, std::size_t n, ByteStats& stats) {
+      SubHistograms tables { };
+      std::size_t i { 0 };
+
+      // Two words per iteration: one 8-byte load instead of eight 1-byte ones
+      for (; i + 16 <= n; i += 16) {
+        std::uint64_t low, high;
+        std::memcpy(&low,  bytes + i,     8);
+        std::memcpy(&high, bytes + i + 8, 8);
+
+        countWord(tables, low);
+        countWord(tables, high);
+      }
+
+      for (; i < n; ++i)
+        ++tables[i % subHistograms][bytes[i]];
+
+      for (std::size_t value { 0 }; value < 256; ++value) {
+        std::uint64_t sum { 0 };
+
+        for (const auto& table : tables)
+          sum += table[value];
+
+        stats.counts[value] += sum;
+      }
+    }
+  }
+
+  const char* className(CharClass charClass) {
+    switch (charClass) {
+      case CharClass::control:     return "control";
+      case CharClass::whitespace:  return "whitespace";
+      case CharClass::digit:       return "digit";
+      case CharClass::letter:      return "letter";
+      case CharClass::punctuation: return "punctuation";
+      default:                     return "non-ASCII";
+    }
+  }
+
+  std::uint64_t ByteStats::total() const {
+    std::uint64_t sum { 0 };
+
+    for (const std::uint64_t count : counts)
+      sum += count;
+
+    return sum;
+  }
+
+  std::array<std::uint64_t, charClassCount> ByteStats::classes() const {
+    std::array<std::uint64_t, charClassCount> sums { };
+
+    for (std::size_t value { 0 }; value < 256; ++value)
+      sums[static_cast<std::size_t>(classOf(static_cast<std::uint8_t>(value)))] += counts[value];
+
+    return sums;
+  }
+
+  void ByteStats::merge(const ByteStats& other) {
+    for (std::size_t value { 0 }; value < 256; ++value)
+      counts[value] += other.counts[value];
+  }
+
+  ByteStats countBytes(std::span<const std::uint8_t> bytes) {
+    ByteStats stats { };
+
+    for (std::size_t done { 0 }; done < bytes.size(); done += roundBytes)
+      countRound(bytes.data() + done, std::min(roundBytes, bytes.size() - done), stats);
+
+    return stats;
+  }
+
+  ByteStats countBytesScalar(std::span<const std::uint8_t> bytes) {
+    ByteStats stats { };
+
+    for (const std::uint8_t byte : bytes)
+      ++stats.counts[byte];
+
+    return stats;
+  }
+
+  ByteStats countBytesParallel(std::span<const std::uint8_t> bytes, unsigned threads) {
+    if (threads == 0)
+      threads = std::max(1u, std::thread::hardware_concurrency());
+
+    // Below a few pages per thread, starting threads costs more than counting
+    threads = static_cast<unsigned>(std::clamp<std::size_t>(bytes.size() >> 16, 1, threads));
+
+    if (threads == 1)
+      return countBytes(bytes);
+
+    // Each thread counts its own slice into its own histogram; nothing is
+    // shared until the merge
+    std::vector<ByteStats>   partial(threads);
+    std::vector<std::thread> workers { };
+    const std::size_t        perThread { (bytes.size() + threads - 1) / threads };
+
+    for (unsigned t { 0 }; t < threads; ++t) {
+      workers.emplace_back([&, t] {
+        const std::size_t begin { std::min(bytes.size(), t * perThread) };
+        const std::size_t end   { std::min(bytes.size(), begin + perThread) };
+
+        partial[t] = countBytes(bytes.subspan(begin, end - begin));
+      });
+    }
+
+    for (std::thread& worker : workers)
+      worker.join();
+
+    ByteStats stats { };
+
+    for (const ByteStats& slice : partial)
+      stats.merge(slice);
+
+    return stats;
+  }
+
+  bool countFile(const char* path, ByteStats& stats, unsigned threads) {
+    const int fd { open(path, O_RDONLY) };
+
+    if (fd < 0)
+      return false;
+
+    struct stat info { };
+
+    if (fstat(fd, &info) != 0) {
+      close(fd);
+      return false;
+    }
+
+    const auto size { static_cast<std::size_t>(info.st_size) };
+    stats = ByteStats { };
+
+    // mmap refuses a zero-length mapping, and there is nothing to count
+    if (size == 0) {
+      close(fd);
+      return true;
+    }
+
+    void* address { mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0) };
+    close(fd);
+
+    if (address == MAP_FAILED)
+      return false;
+
+    madvise(address, size, MADV_SEQUENTIAL);
+    stats = countBytesParallel({ static_cast<const std::uint8_t*>(address), size }, threads);
+    munmap(address, size);
+
+    return true;
+  }
+}
@@ -0,0 +1,72 @@
+// +--------------------------------------------+
+// |      BYTE HISTOGRAM AND CHARACTER CLASSES  |
+// +--------------------------------------------+
+//
+// ascii_code maps one character to its code. This counts every code in a
+// whole file: how often each of the 256 byte values occurs, and from that
+// how many digits, letters, whitespace, control and other bytes there are.
+//
+// The obvious loop, ++counts[byte], is slow exactly when the data is
+// boring: a run of the same byte increments the same counter again and
+// again, and each increment waits for the previous store to reach its load
+// (store-to-load forwarding, several cycles per byte). So bytes are spread
+// over eight sub-histograms in turn, one per byte of a 64-bit load.
+// Neighbouring bytes hit different tables, the increments no longer wait
+// on each other, and the tables are summed at the end. Counters are 32-bit
+// while counting (a round covers 4 GiB at most), which keeps the eight
+// tables in 8 KiB of L1. Four tables were measurably slower on repeated
+// bytes; more than eight only adds L1 pressure.
+//
+// countFile maps the file and gives each thread a contiguous slice; each
+// thread builds its own histogram and they are merged after the join.
+// Character classes are read off the merged histogram (one 256-entry
+// pass), so they cost nothing per byte.
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+namespace Ascii {
+  enum class CharClass : std::uint8_t { control, whitespace, digit, letter, punctuation, nonAscii };
+
+  inline constexpr std::size_t charClassCount { 6 };
+
+  // ' ', \t, \n, \v, \f and \r are whitespace rather than control
+  constexpr CharClass classOf(std::uint8_t byte) {
+    if (byte >= 0x80)                                   return CharClass::nonAscii;
+    if (byte == ' ' || (byte >= '\t' && byte <= '\r'))  return CharClass::whitespace;
+    if (byte < 0x20 || byte == 0x7F)                    return CharClass::control;
+    if (byte >= '0' && byte <= '9')                     return CharClass::digit;
+    if ((byte | 0x20) >= 'a' && (byte | 0x20) <= 'z')   return CharClass::letter;
+    return CharClass::punctuation;
+  }
+
+  const char* className(CharClass charClass);
+
+  struct ByteStats {
+    std::array<std::uint64_t, 256> counts { };
+
+    std::uint64_t total() const;
+
+    // Bytes of each CharClass, indexed by its value
+    std::array<std::uint64_t, charClassCount> classes() const;
+
+    void merge(const ByteStats& other);
+  };
+
+  // One thread, eight sub-histograms
+  ByteStats countBytes(std::span<const std::uint8_t> bytes);
+
+  // ++counts[byte]: the reference, and the baseline for the benchmark
+  ByteStats countBytesScalar(std::span<const std::uint8_t> bytes);
+
+  // countBytes over `threads` slices (0: every hardware thread), merged
+  ByteStats countBytesParallel(std::span<const std::uint8_t> bytes, unsigned threads = 0);
+
+  // Maps the file at `path` and counts it with countBytesParallel. False if
+  // it cannot be opened or mapped.
+  bool countFile(const char* path, ByteStats& stats, unsigned threads = 0);
+}
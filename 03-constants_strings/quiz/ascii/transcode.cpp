@@ -0,0 +1,277 @@
+#include "transcode.h"
+
+#include "../../../common/radix_format.h"
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <cstring>
+#include <vector>
+
+#include <unistd.h>
+
+#ifdef __SSE2__
+  #include <emmintrin.h>
+#endif
+
+namespace Ascii {
+  namespace {
+    constexpr std::size_t bytesPerLine { 16 };
+
+    struct Escape {
+      char          text[4] { };
+      std::uint8_t  length  { 0 };
+    };
+
+    constexpr bool isPlain(unsigned char c) {
+      return c >= 0x20 && c <= 0x7E && c != '\\';
+    }
+
+    constexpr std::array<Escape, 256> makeEscapes() {
+      constexpr char hexDigits[] { "0123456789abcdef" };
+      std::array<Escape, 256> escapes { };
+
+      for (int c { 0 }; c < 256; ++c) {
+        Escape& e { escapes[static_cast<std::size_t>(c)] };
+
+        switch (c) {
+          case '\n': e = Escape { { '\\', 'n', '\n' }, 3 }; break;
+          case '\t': e = Escape { { '\\', 't' },       2 }; break;
+          case '\r': e = Escape { { '\\', 'r' },       2 }; break;
+          case '\0': e = Escape { { '\\', '0' },       2 }; break;
+          case '\\': e = Escape { { '\\', '\\' },      2 }; break;
+
+          default:
+            if (isPlain(static_cast<unsigned char>(c)))
+              e = Escape { { static_cast<char>(c) }, 1 };
+            else
+              e = Escape { { '\\', 'x', hexDigits[c >> 4], hexDigits[c & 15] }, 4 };
+        }
+      }
+
+      return escapes;
+    }
+
+    constexpr std::array<Escape, 256> escapes { makeEscapes() };
+
+    // "ddd" right-aligned, then ' ' or '\n'
+    char* decimalScalar(const std::uint8_t* in, std::size_t begin, std::size_t n, char* out) {
+      for (std::size_t i { begin }; i < n; ++i) {
+        const unsigned b { in[i] };
+
+        out[0] = b >= 100 ? static_cast<char>('0' + b / 100) : ' ';
+        out[1] = b >= 10  ? static_cast<char>('0' + b / 10 % 10) : ' ';
+        out[2] = static_cast<char>('0' + b % 10);
+        out[3] = (i + 1) % bytesPerLine == 0 ? '\n' : ' ';
+        out += 4;
+      }
+
+      return out;
+    }
+
+#ifdef __SSE2__
+    // Hundreds, tens and ones of eight bytes in 16-bit lanes. x / 100 is
+    // (x * 41) >> 12 and x / 10 is (x * 205) >> 11 for every byte value.
+    void splitDigits(__m128i x, __m128i& hundreds, __m128i& tens, __m128i& ones) {
+      hundreds = _mm_srli_epi16(_mm_mullo_epi16(x, _mm_set1_epi16(41)), 12);
+      const __m128i rest { _mm_sub_epi16(x, _mm_mullo_epi16(hundreds, _mm_set1_epi16(100))) };
+      tens = _mm_srli_epi16(_mm_mullo_epi16(rest, _mm_set1_epi16(205)), 11);
+      ones = _mm_sub_epi16(rest, _mm_mullo_epi16(tens, _mm_set1_epi16(10)));
+    }
+
+    // 16 bytes -> 64 characters, one line
+    char* decimalSse2(const std::uint8_t* in, std::size_t n, std::size_t& done, char* out) {
+      const __m128i zero   { _mm_setzero_si128() };
+      const __m128i digit0 { _mm_set1_epi8('0') };
+      const __m128i blank  { _mm_set1_epi8(' ') };
+
+      // Every slot ends in a space except the last, which ends the line
+      const __m128i lastGap { _mm_setr_epi8(' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', '\n') };
+
+      for (done = 0; done + bytesPerLine <= n; done += bytesPerLine) {
+        const __m128i v { _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + done)) };
+
+        __m128i h[2], t[2], o[2];
+        splitDigits(_mm_unpacklo_epi8(v, zero), h[0], t[0], o[0]);
+        splitDigits(_mm_unpackhi_epi8(v, zero), h[1], t[1], o[1]);
+
+        const __m128i hundreds { _mm_packus_epi16(h[0], h[1]) };
+        const __m128i tens     { _mm_packus_epi16(t[0], t[1]) };
+        const __m128i ones     { _mm_packus_epi16(o[0], o[1]) };
+
+        // Leading zeros become spaces
+        const __m128i noHundreds { _mm_cmpeq_epi8(hundreds, zero) };
+        const __m128i noTens     { _mm_and_si128(noHundreds, _mm_cmpeq_epi8(tens, zero)) };
+
+        const __m128i hundredsText { _mm_or_si128(_mm_andnot_si128(noHundreds, _mm_add_epi8(hundreds, digit0)), _mm_and_si128(noHundreds, blank)) };
+        const __m128i tensText     { _mm_or_si128(_mm_andnot_si128(noTens, _mm_add_epi8(tens, digit0)), _mm_and_si128(noTens, blank)) };
+        const __m128i onesText     { _mm_add_epi8(ones, digit0) };
+
+        // Byte i's four characters: hundreds, tens, ones, gap
+        const __m128i highPairs[2] { _mm_unpacklo_epi8(hundredsText, tensText), _mm_unpackhi_epi8(hundredsText, tensText) };
+        const __m128i lowPairs[2]  { _mm_unpacklo_epi8(onesText, blank),         _mm_unpackhi_epi8(onesText, lastGap) };
+
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out),      _mm_unpacklo_epi16(highPairs[0], lowPairs[0]));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 16), _mm_unpackhi_epi16(highPairs[0], lowPairs[0]));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 32), _mm_unpacklo_epi16(highPairs[1], lowPairs[1]));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 48), _mm_unpackhi_epi16(highPairs[1], lowPairs[1]));
+        out += 64;
+      }
+
+      return out;
+    }
+#endif
+
+    std::size_t decimal(std::span<const std::uint8_t> in, char* out) {
+      char* p { out };
+      std::size_t done { 0 };
+
+#ifdef __SSE2__
+      p = decimalSse2(in.data(), in.size(), done, p);
+#endif
+
+      p = decimalScalar(in.data(), done, in.size(), p);
+
+      if (p > out)
+        p[-1] = '\n';
+
+      return static_cast<std::size_t>(p - out);
+    }
+
+    std::size_t hex(std::span<const std::uint8_t> in, char* out) {
+      const std::size_t used { RadixFormat::writeBytes(in, RadixFormat::Options { }, out) };
+
+      for (std::size_t line { 3 * bytesPerLine - 1 }; line < used; line += 3 * bytesPerLine)
+        out[line] = '\n';
+
+      if (used > 0)
+        out[used - 1] = '\n';
+
+      return used;
+    }
+
+    std::size_t escaped(std::span<const std::uint8_t> in, char* out) {
+      const std::uint8_t* p    { in.data() };
+      const std::uint8_t* last { in.data() + in.size() };
+      char* at { out };
+
+      for (;;) {
+#ifdef __SSE2__
+        // Copy 16 bytes at a time, then keep only the plain prefix
+        while (last - p >= 16) {
+          const __m128i v     { _mm_loadu_si128(reinterpret_cast<const __m128i*>(p)) };
+          const __m128i plain { _mm_andnot_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8('\\')),
+                                                 _mm_and_si128(_mm_cmpgt_epi8(v, _mm_set1_epi8(0x1F)),
+                                                               _mm_cmplt_epi8(v, _mm_set1_epi8(0x7F)))) };
+          const unsigned special { ~static_cast<unsigned>(_mm_movemask_epi8(plain)) & 0xFFFFu };
+
+          _mm_storeu_si128(reinterpret_cast<__m128i*>(at), v);
+
+          if (!special) {
+            p  += 16;
+            at += 16;
+            continue;
+          }
+
+          const auto run { static_cast<unsigned>(__builtin_ctz(special)) };
+          p  += run;
+          at += run;
+          break;
+        }
+#endif
+
+        if (p == last)
+          break;
+
+        const Escape& e { escapes[*p++] };
+        std::memcpy(at, e.text, sizeof(e.text));
+        at += e.length;
+      }
+
+      return static_cast<std::size_t>(at - out);
+    }
+
+    // read(2) until the buffer is full or the input ends
+    bool fill(int fd, std::uint8_t* buffer, std::size_t capacity, std::size_t& got) {
+      got = 0;
+
+      while (got < capacity) {
+        const ssize_t n { ::read(fd, buffer + got, capacity - got) };
+
+        if (n < 0 && errno == EINTR)
+          continue;
+
+        if (n < 0)
+          return false;
+
+        if (n == 0)
+          break;
+
+        got += static_cast<std::size_t>(n);
+      }
+
+      return true;
+    }
+
+    bool writeAll(int fd, const char* data, std::size_t size) {
+      while (size > 0) {
+        const ssize_t n { ::write(fd, data, size) };
+
+        if (n < 0 && errno == EINTR)
+          continue;
+
+        if (n <= 0)
+          return false;
+
+        data += n;
+        size -= static_cast<std::size_t>(n);
+      }
+
+      return true;
+    }
+  }
+
+  bool parseListing(std::string_view name, Listing& listing) {
+    if (name == "decimal")
+      listing = Listing::decimal;
+    else if (name == "hex")
+      listing = Listing::hex;
+    else if (name == "escaped")
+      listing = Listing::escaped;
+    else
+      return false;
+
+    return true;
+  }
+
+  std::size_t transcode(std::span<const std::uint8_t> in, Listing listing, char* out) {
+    switch (listing) {
+      case Listing::decimal: return decimal(in, out);
+      case Listing::hex:     return hex(in, out);
+      default:               return escaped(in, out);
+    }
+  }
+
+  bool transcodeStream(int inFd, int outFd, Listing listing, std::size_t chunkBytes) {
+    chunkBytes = (std::max<std::size_t>(chunkBytes, 1) + bytesPerLine - 1) / bytesPerLine * bytesPerLine;
+
+    std::vector<std::uint8_t> in(chunkBytes);
+    std::vector<char> out(chunkBytes * maxExpansion(listing));
+
+    for (std::size_t got { }; ; ) {
+      if (!fill(inFd, in.data(), in.size(), got))
+        return false;
+
+      if (got == 0)
+        return true;
+
+      const std::size_t used { transcode(std::span<const std::uint8_t> { in.data(), got }, listing, out.data()) };
+
+      if (!writeAll(outFd, out.data(), used))
+        return false;
+
+      if (got < in.size())
+        return true;
+    }
+  }
+}
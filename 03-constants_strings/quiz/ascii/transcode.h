@@ -0,0 +1,51 @@
+// +--------------------------------------------+
+// |        BYTE -> CODE LISTING TRANSCODER     |
+// +--------------------------------------------+
+//
+// ascii_code prints the code of one character. This does the same for a
+// whole file, 16 bytes per line:
+//
+//   decimal   od -t u1 style, right-aligned: " 72 101 108 108 111  10"
+//   hex       "48 65 6c 6c 6f 0a"
+//   escaped   the text itself, with \n, \t, \\ and \xHH for anything not
+//             printable ASCII (a real line break follows each \n)
+//
+// decimal works on 16 bytes at once with SSE2: hundreds, tens and ones come
+// from multiply-shift reciprocals (no division), leading zeros are blended
+// to spaces, and unpacks lay each byte out in its 4-character slot. hex is
+// RadixFormat's pshufb nibble lookup. escaped copies 16 plain bytes per
+// store and only stops at a byte that needs an escape, which comes from a
+// 256-entry table.
+//
+// Input is read in large chunks into one buffer and transcoded into an
+// output buffer allocated once for the worst case, so nothing is resized
+// or copied twice.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string_view>
+
+namespace Ascii {
+  enum class Listing { decimal, hex, escaped };
+
+  // Most output bytes one input byte can turn into
+  constexpr std::size_t maxExpansion(Listing listing) {
+    return listing == Listing::hex ? 3 : 4;
+  }
+
+  // "decimal", "hex" or "escaped"
+  bool parseListing(std::string_view name, Listing& listing);
+
+  // Listing of `in` into out (maxExpansion(listing) * in.size() bytes);
+  // returns the number of bytes written. Lines hold 16 input bytes counted
+  // from the start of `in`, so split longer inputs at multiples of 16.
+  std::size_t transcode(std::span<const std::uint8_t> in, Listing listing, char* out);
+
+  // Reads inFd to the end and writes its listing to outFd, `chunkBytes`
+  // (rounded up to a multiple of 16) at a time. False on a read or write
+  // error.
+  bool transcodeStream(int inFd, int outFd, Listing listing, std::size_t chunkBytes = 1 << 20);
+}
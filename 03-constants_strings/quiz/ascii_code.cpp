@@ -1,12 +1,117 @@
-#include <iostream>
+// g++ -std=c++20 -O2 -pthread ascii_code.cpp ascii/transcode.cpp ascii/histogram.cpp ../../common/radix_format.cpp ../../common/utf8.cpp -o ascii_code
+// ./ascii_code                        asks for one character (any UTF-8 character)
+// ./ascii_code hex file.bin           listing of a whole file: decimal, hex or escaped
+// ./ascii_code decimal - < file.bin   (- or no file reads stdin)
+// ./ascii_code stats big.log          how often each code occurs, and character classes
 
-int main() {
-  char character;
+#include "ascii/histogram.h"
+#include "ascii/transcode.h"
+#include "../../common/console.h"
+#include "../../common/radix_format.h"
+#include "../../common/utf8.h"
 
-  std::cout << "?: ";
-  std::cin  >> character;
+#include <cstdio>
+#include <string>
+#include <string_view>
 
-  std::cout << "User input: " << character << " ASCII Code Representation: " << static_cast<int>(character) << '\n';
+#include <fcntl.h>
+#include <unistd.h>
+
+// Byte frequencies of a whole file, counted on every core
+int printStats(const char* path) {
+  Ascii::ByteStats stats { };
+
+  if (!Ascii::countFile(path, stats)) {
+    std::perror(path);
+    return 1;
+  }
+
+  const auto total   { static_cast<unsigned long long>(stats.total()) };
+  const auto classes { stats.classes() };
+  const double scale { total > 0 ? 100.0 / static_cast<double>(total) : 0.0 };
+
+  std::printf("%llu bytes\n", total);
+
+  for (std::size_t c { 0 }; c < Ascii::charClassCount; ++c)
+    std::printf("  %-12s %14llu  %6.2f%%\n", Ascii::className(static_cast<Ascii::CharClass>(c)),
+                static_cast<unsigned long long>(classes[c]), scale * static_cast<double>(classes[c]));
+
+  std::printf("\ncode  char          count\n");
+
+  for (std::size_t code { 0 }; code < 256; ++code) {
+    if (stats.counts[code] == 0)
+      continue;
+
+    const bool printable { code > ' ' && code < 0x7F };
+    std::printf("%4zu  %c    %14llu\n", code, printable ? static_cast<char>(code) : ' ',
+                static_cast<unsigned long long>(stats.counts[code]));
+  }
+
+  return 0;
+}
+
+int main(int argc, char** argv) {
+  if (argc > 2 && std::string_view { argv[1] } == "stats")
+    return printStats(argv[2]);
+
+  if (argc > 1) {
+    Ascii::Listing listing { };
+
+    if (!Ascii::parseListing(argv[1], listing)) {
+      std::fprintf(stderr, "usage: %s [decimal|hex|escaped] [file]\n"
+                           "       %s stats file\n", argv[0], argv[0]);
+      return 2;
+    }
+
+    const bool fromStdin { argc < 3 || std::string_view { argv[2] } == "-" };
+    const int fd { fromStdin ? 0 : open(argv[2], O_RDONLY) };
+
+    if (fd < 0) {
+      std::perror(argv[2]);
+      return 1;
+    }
+
+    const bool ok { Ascii::transcodeStream(fd, 1, listing) };
+
+    if (!fromStdin)
+      close(fd);
+
+    return ok ? 0 : 1;
+  }
+
+  std::string character { };
+
+  Console::out << "?: ";
+  Console::in  >> character;
+
+  // A character outside ASCII is several bytes; only the first one typed counts
+  std::u32string codePoints(character.size(), U'\0');
+  const std::size_t count { Utf8::decode(character, codePoints.data()) };
+
+  if (count == Utf8::npos || count == 0) {
+    Console::out << "That isn't valid UTF-8\n";
+    return 1;
+  }
+
+  const char32_t codePoint { codePoints[0] };
+
+  if (codePoint < 0x80) {
+    Console::out << "User input: " << static_cast<char>(codePoint) << " ASCII Code Representation: " << static_cast<int>(codePoint) << '\n';
+    return 0;
+  }
+
+  // U+00E9, U+1F600: at least 4 hex digits
+  RadixFormat::Options hex { };
+  hex.upperCase  = true;
+  hex.fixedWidth = codePoint <= 0xFFFF;
+
+  char digits[8];
+  const char* end { RadixFormat::write(digits, codePoint, hex, 16) };
+  const std::size_t encoded { codePoint < 0x800 ? 2u : codePoint < 0x10000 ? 3u : 4u };
+
+  Console::out << "User input: " << std::string_view { character.data(), encoded }
+               << " Unicode Code Point: U+" << std::string_view { digits, static_cast<std::size_t>(end - digits) }
+               << " (" << static_cast<unsigned>(codePoint) << ")\n";
 
   return 0;
 }
@@ -0,0 +1,107 @@
+// +--------------------------------------------+
+// |         BIG INTEGER ARITHMETIC COST        |
+// +--------------------------------------------+
+//
+// g++ -std=c++20 -O2 bigint.cpp bench_bigint.cpp -o bench_bigint
+// ./bench_bigint [tune]
+//
+// Times multiply (schoolbook vs Karatsuba), divmod and decimal conversion at
+// 1k, 10k and 100k digits. "tune" sweeps the Karatsuba threshold instead
+// (through BigInt::multiply, so karatsubaThreshold itself stays constexpr).
+
+#include "bigint.h"
+
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <string>
+
+namespace {
+  std::mt19937_64 rng { 2024 };
+
+  std::string randomDigits(std::size_t digits) {
+    std::string s(digits, '0');
+    s[0] = static_cast<char>('1' + rng() % 9);
+
+    for (std::size_t i { 1 }; i < digits; ++i)
+      s[i] = static_cast<char>('0' + rng() % 10);
+
+    return s;
+  }
+
+  Calc::BigInt parse(const std::string& s) {
+    Calc::BigInt x { };
+    Calc::BigInt::fromString(s, x);
+
+    return x;
+  }
+
+  // Milliseconds per call, repeating until at least 0.2 s has passed
+  template <typename F>
+  double timeMs(F&& f) {
+    long reps { 0 };
+    auto start { std::chrono::steady_clock::now() };
+    double elapsed { 0.0 };
+
+    do {
+      f();
+      ++reps;
+      elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    } while (elapsed < 0.2);
+
+    return elapsed * 1e3 / static_cast<double>(reps);
+  }
+
+  void tune() {
+    for (std::size_t digits : { 2'000, 5'000, 20'000 }) {
+      const Calc::BigInt a { parse(randomDigits(digits)) };
+      const Calc::BigInt b { parse(randomDigits(digits)) };
+
+      std::cout << digits << " digit multiply by threshold (limbs):\n";
+
+      for (std::size_t t : { 16, 24, 32, 40, 48, 64, 96, 128 }) {
+        std::cout << "  " << t << ": " << timeMs([&] { return Calc::BigInt::multiply(a, b, t); }) << " ms\n";
+      }
+    }
+  }
+}
+
+int main(int argc, char** argv) {
+  if (argc > 1 && std::strcmp(argv[1], "tune") == 0) {
+    tune();
+    return 0;
+  }
+
+  for (std::size_t digits : { 1'000, 10'000, 100'000 }) {
+    const std::string sa { randomDigits(digits) };
+    const std::string sb { randomDigits(digits) };
+    const Calc::BigInt a { parse(sa) };
+    const Calc::BigInt b { parse(sb) };
+
+    constexpr std::size_t never { std::numeric_limits<std::size_t>::max() };
+    const Calc::BigInt school { Calc::BigInt::multiply(a, b, never) };
+    const double schoolMs { timeMs([&] { return Calc::BigInt::multiply(a, b, never); }) };
+
+    const Calc::BigInt product { a * b };
+    const double karatsubaMs { timeMs([&] { return a * b; }) };
+
+    Calc::BigInt q { }, r { };
+    const double divmodMs { timeMs([&] { Calc::BigInt::divmod(product, b, q, r); }) };
+    const double toStringMs { timeMs([&] { return product.toString(); }) };
+    const std::string text { product.toString() };
+    const double fromStringMs { timeMs([&] { return parse(text); }) };
+
+    const bool ok { school == product && q == a && r.isZero() && a.toString() == sa && parse(text) == product };
+
+    std::cout << digits << " digits (" << a.limbs().size() << " limbs)" << (ok ? "" : "  MISMATCH") << '\n'
+              << "  multiply schoolbook: " << schoolMs     << " ms\n"
+              << "  multiply karatsuba:  " << karatsubaMs  << " ms\n"
+              << "  divmod (2n / n):     " << divmodMs     << " ms\n"
+              << "  toString (2n):       " << toStringMs   << " ms\n"
+              << "  fromString (2n):     " << fromStringMs << " ms\n";
+  }
+
+  return 0;
+}
@@ -0,0 +1,116 @@
+// +--------------------------------------------+
+// |        COLUMNAR KERNEL THROUGHPUT          |
+// +--------------------------------------------+
+//
+// g++ -std=c++20 -O2 columns.cpp bench_columns.cpp ../../../common/checked.cpp ../../../common/int_parse.cpp -o bench_columns
+// ./bench_columns [rows]   (default: 64M rows)
+//
+// Built without -march so the runtime dispatch is what picks the kernel.
+// Every kernel must report the same first overflowing row as the scalar one,
+// and 2147483647 + 1 in the middle of a small batch must be caught.
+
+#include "columns.h"
+
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <random>
+
+namespace {
+  double secondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  }
+
+  const char* operationName(Calc::Operation op) {
+    switch (op) {
+      case Calc::Operation::add:      return "add     ";
+      case Calc::Operation::subtract: return "subtract";
+      case Calc::Operation::multiply: return "multiply";
+      default:                        return "divide  ";
+    }
+  }
+
+  // One overflowing row among 99 that fit, checked with every kernel
+  bool overflowIsReported(Calc::Isa best) {
+    Calc::Columns columns { };
+
+    for (std::int32_t i { 0 }; i < 100; ++i) {
+      columns.a.push_back(i == 57 ? 2147483647 : i);
+      columns.b.push_back(1);
+    }
+
+    for (Calc::Isa isa : { Calc::Isa::scalar, Calc::Isa::sse41, Calc::Isa::avx2 }) {
+      if (isa <= best && Calc::runBatch(Calc::Operation::add, columns, isa).overflow != 57u)
+        return false;
+    }
+
+    return true;
+  }
+}
+
+int main(int argc, char** argv) {
+  const std::size_t rows { argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 64ull << 20 };
+
+  Calc::Columns columns { };
+  columns.a.resize(rows);
+  columns.b.resize(rows);
+
+  std::mt19937 rng { 3 };
+  for (std::size_t i { 0 }; i < rows; ++i) {
+    columns.a[i] = static_cast<std::int32_t>(rng());
+    columns.b[i] = static_cast<std::int32_t>(rng() % 1000) - 500; // some zero divisors
+  }
+
+  const Calc::Isa best { Calc::detectIsa() };
+  std::cout << "best kernel on this CPU: " << Calc::isaName(best) << '\n';
+  std::cout << "2147483647 + 1 reported: " << (overflowIsReported(best) ? "yes\n\n" : "no  [WRONG]\n\n");
+
+  // Outputs are allocated and touched once so the timings are kernel-only
+  Calc::AlignedVector<std::int32_t> integers(rows), referenceIntegers(rows);
+  Calc::AlignedVector<double>       quotients(rows), referenceQuotients(rows);
+  std::vector<std::size_t>          zeros { }, referenceZeros { };
+  std::size_t                       overflow { }, referenceOverflow { };
+
+  for (Calc::Operation op : { Calc::Operation::add, Calc::Operation::subtract,
+                              Calc::Operation::multiply, Calc::Operation::divide }) {
+    const bool divide { op == Calc::Operation::divide };
+
+    if (divide)
+      Calc::divideColumns(columns.a.data(), columns.b.data(), referenceQuotients.data(), rows, referenceZeros, Calc::Isa::scalar);
+    else
+      referenceOverflow = Calc::applyIntegers(op, columns.a.data(), columns.b.data(), referenceIntegers.data(), rows, Calc::Isa::scalar);
+
+    for (Calc::Isa isa : { Calc::Isa::scalar, Calc::Isa::sse41, Calc::Isa::avx2 }) {
+      if (isa > best)
+        continue;
+
+      zeros.clear();
+
+      auto start { std::chrono::steady_clock::now() };
+      if (divide)
+        Calc::divideColumns(columns.a.data(), columns.b.data(), quotients.data(), rows, zeros, isa);
+      else
+        overflow = Calc::applyIntegers(op, columns.a.data(), columns.b.data(), integers.data(), rows, isa);
+      double seconds { secondsSince(start) };
+
+      // NaN != NaN, so compare quotients bit for bit
+      const bool same {
+        divide ? zeros == referenceZeros
+                   && std::memcmp(quotients.data(), referenceQuotients.data(), rows * sizeof(double)) == 0
+               : overflow == referenceOverflow && integers == referenceIntegers
+      };
+
+      std::cout << operationName(op) << ' ' << Calc::isaName(isa) << ":\t"
+                << rows / seconds / 1e6 << " M rows/s";
+
+      if (divide)
+        std::cout << " (" << zeros.size() << " zero divisors)";
+
+      std::cout << (same ? "\n" : "  [MISMATCH]\n");
+    }
+  }
+
+  return 0;
+}
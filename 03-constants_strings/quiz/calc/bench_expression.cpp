@@ -0,0 +1,107 @@
+// +--------------------------------------------+
+// |       TREE WALKER VS THREADED BYTECODE     |
+// +--------------------------------------------+
+//
+// g++ -std=c++20 -O2 -march=native expression.cpp bytecode.cpp bench_expression.cpp -o bench_expr
+// ./bench_expr ["expression"] [evaluations]
+//
+// Before timing, checks that a very long chain parses, compiles and
+// evaluates without running out of stack, and that deeply nested input is
+// rejected with a ParseError instead.
+
+#include "bytecode.h"
+#include "expression.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace {
+  double secondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  }
+
+  std::string repeat(std::string_view piece, int times) {
+    std::string text { };
+
+    for (int i { 0 }; i < times; ++i)
+      text += piece;
+
+    return text;
+  }
+
+  // x + x + ... + x with `terms` terms, at x = 1
+  bool longChainWorks(int terms) {
+    Calc::Expression expr { };
+    Calc::ParseError error { };
+
+    if (!Calc::parse("x" + repeat(" + x", terms - 1), expr, error))
+      return false;
+
+    const double x[] { 1.0 };
+    return Calc::evaluateTree(expr, x) == terms && Calc::Bytecode { expr }.run(x) == terms;
+  }
+
+  // `depth` levels of parentheses around x, at x = 2
+  bool nestingWorks(int depth, bool expectTooDeep) {
+    Calc::Expression expr { };
+    Calc::ParseError error { };
+
+    if (!Calc::parse(repeat("(", depth) + "x" + repeat(")", depth), expr, error))
+      return expectTooDeep && error.message == "expression nested too deeply";
+
+    const double x[] { 2.0 };
+    return !expectTooDeep && Calc::evaluateTree(expr, x) == 2.0 && Calc::Bytecode { expr }.run(x) == 2.0;
+  }
+}
+
+int main(int argc, char** argv) {
+  std::string source { argc > 1 ? argv[1] : "(x + 3) * (y - 2) / (x * x + 1) - y * y + 0.5 * x - (2 ^ 3) * z" };
+  long evaluations   { argc > 2 ? std::strtol(argv[2], nullptr, 10) : 10'000'000L };
+
+  std::cout << "300000-term chain"         << (longChainWorks(300'000)     ? "" : "  [WRONG]") << '\n'
+            << "500 nested parentheses"    << (nestingWorks(500, false)    ? "" : "  [WRONG]") << '\n'
+            << "200000 nested parentheses" << (nestingWorks(200'000, true) ? " rejected" : "  [WRONG]") << "\n\n";
+
+  Calc::Expression expr { };
+  Calc::ParseError error { };
+
+  if (!Calc::parse(source, expr, error)) {
+    std::cout << "parse error at " << error.position << ": " << error.message << '\n';
+    return 1;
+  }
+
+  const Calc::Bytecode code { expr };
+  std::cout << source << "\n  " << expr.nodes.size() << " tree nodes, "
+            << code.instructionCount() << " instructions, " << code.registerCount() << " registers\n";
+
+  // A different binding for every evaluation
+  std::vector<double> vars(expr.variables.size(), 0.0);
+
+  auto start { std::chrono::steady_clock::now() };
+  double treeSum { 0.0 };
+  for (long i { 0 }; i < evaluations; ++i) {
+    for (std::size_t v { 0 }; v < vars.size(); ++v)
+      vars[v] = static_cast<double>(i % 1000) + static_cast<double>(v);
+    treeSum += Calc::evaluateTree(expr, vars);
+  }
+  const double treeSeconds { secondsSince(start) };
+
+  start = std::chrono::steady_clock::now();
+  double vmSum { 0.0 };
+  for (long i { 0 }; i < evaluations; ++i) {
+    for (std::size_t v { 0 }; v < vars.size(); ++v)
+      vars[v] = static_cast<double>(i % 1000) + static_cast<double>(v);
+    vmSum += code.run(vars);
+  }
+  const double vmSeconds { secondsSince(start) };
+
+  std::cout << "tree walker: " << treeSeconds * 1e9 / evaluations << " ns/eval (sum " << treeSum << ")\n";
+  std::cout << "bytecode VM: " << vmSeconds * 1e9 / evaluations << " ns/eval (sum " << vmSum << ")\n";
+  std::cout << "speedup:     " << treeSeconds / vmSeconds << "x\n";
+
+  return 0;
+}
@@ -0,0 +1,93 @@
+// +--------------------------------------------+
+// |      PER-EVALUATION COST OF EACH TIER      |
+// +--------------------------------------------+
+//
+// g++ -std=c++20 -O2 expression.cpp bytecode.cpp jit.cpp bench_jit.cpp -o bench_jit
+// ./bench_jit ["expression"] [evaluations]
+//
+// First, a 300000-term chain with a constant subtree in every term is
+// compiled to machine code: it must not run out of stack, must take time
+// linear in its length, and must agree with the bytecode.
+
+#include "bytecode.h"
+#include "expression.h"
+#include "jit.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace {
+  template <typename Evaluate>
+  void timeTier(const char* name, std::size_t variableCount, long evaluations, Evaluate&& evaluate) {
+    std::vector<double> vars(variableCount);
+    double sum { 0.0 };
+
+    auto start { std::chrono::steady_clock::now() };
+
+    for (long i { 0 }; i < evaluations; ++i) {
+      for (std::size_t v { 0 }; v < vars.size(); ++v)
+        vars[v] = static_cast<double>(i % 1000) * 0.5 + static_cast<double>(v);
+
+      sum += evaluate(vars);
+    }
+
+    const double seconds { std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() };
+    std::cout << name << seconds * 1e9 / evaluations << " ns/eval (sum " << sum << ")\n";
+  }
+
+  void checkLongChain(int terms) {
+    std::string source { "x" };
+
+    for (int i { 1 }; i < terms; ++i)
+      source += " + x * (3 - 2)";
+
+    Calc::Expression expr { };
+    Calc::ParseError error { };
+    const bool parsed { Calc::parse(source, expr, error) };
+
+    const auto start { std::chrono::steady_clock::now() };
+    const Calc::JitFunction jit { expr };
+    const double seconds { std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() };
+
+    const double x[] { 1.0 };
+    const bool same { parsed && jit.valid() && jit(x) == terms && Calc::Bytecode { expr }.run(x) == terms };
+
+    std::cout << terms << "-term chain: jit compiled in " << seconds * 1e3 << " ms"
+              << (same || !Calc::JitFunction::supported() ? "" : "  [WRONG]") << "\n\n";
+  }
+}
+
+int main(int argc, char** argv) {
+  std::string source { argc > 1 ? argv[1] : "(x + 3) * (y - 2) / (x * x + 1) - y * y + 0.5 * x - (2 ^ 3) * z + x % 7" };
+  long evaluations   { argc > 2 ? std::strtol(argv[2], nullptr, 10) : 10'000'000L };
+
+  checkLongChain(300'000);
+
+  Calc::Expression expr { };
+  Calc::ParseError error { };
+
+  if (!Calc::parse(source, expr, error)) {
+    std::cout << "parse error at " << error.position << ": " << error.message << '\n';
+    return 1;
+  }
+
+  const Calc::Bytecode    code { expr };
+  const Calc::JitFunction jit  { expr };
+
+  std::cout << source << '\n';
+  std::cout << "jit: " << (jit.valid() ? std::to_string(jit.codeBytes()) + " bytes of machine code\n"
+                                       : std::string { "unavailable, falling back\n" });
+
+  const std::size_t count { expr.variables.size() };
+
+  timeTier("tree walker: ", count, evaluations, [&](const std::vector<double>& v) { return Calc::evaluateTree(expr, v); });
+  timeTier("bytecode VM: ", count, evaluations, [&](const std::vector<double>& v) { return code.run(v); });
+
+  if (jit.valid())
+    timeTier("native JIT:  ", count, evaluations, [&](const std::vector<double>& v) { return jit(v.data()); });
+
+  return 0;
+}
@@ -0,0 +1,143 @@
+// +--------------------------------------------+
+// |        FRACTION REDUCTION THROUGHPUT       |
+// +--------------------------------------------+
+//
+// g++ -std=c++20 -O2 rational.cpp bench_rational.cpp -o bench_rational
+// ./bench_rational [fractions]   (default: 4M)
+//
+// 1. binaryGcd against std::gcd over the full 64-bit range (operands at
+//    and above 2^63 included), and a sum and a product that settle()
+//    reduces through that range
+// 2. reduceAll (Stein) against the same loop with Euclid's modulo gcd
+// 3. a long multiply/divide chain with eager vs lazy reduction
+
+#include "rational.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <numeric>
+#include <random>
+#include <vector>
+
+namespace {
+  std::uint64_t euclidGcd(std::uint64_t a, std::uint64_t b) {
+    while (b) {
+      const std::uint64_t r { a % b };
+      a = b;
+      b = r;
+    }
+
+    return a;
+  }
+
+  // Returns the number of operand pairs where binaryGcd and std::gcd differ
+  std::size_t checkGcd(std::mt19937_64& rng) {
+    std::size_t wrong { 0 };
+    auto check { [&](std::uint64_t a, std::uint64_t b) { wrong += Calc::binaryGcd(a, b) != std::gcd(a, b); } };
+
+    constexpr std::uint64_t top { 1ull << 63 };
+    check(~0ull, 3);
+    check(15404570662242287227ull, 160803960);
+    check(top, top);
+    check(top, 6);
+    check(~0ull, ~0ull - 2);
+
+    for (int i { 0 }; i < 1'000'000; ++i) {
+      const std::uint64_t common { (rng() >> (rng() % 64)) | 1 };
+      check(rng(), rng());
+      check(rng() | top, rng() >> (rng() % 64));
+      check((rng() | top) / common * common, (rng() >> 8) / common * common);
+    }
+
+    return wrong;
+  }
+
+  void reduceAllEuclid(std::vector<Calc::Rational>& values) {
+    for (Calc::Rational& x : values) {
+      const std::uint64_t magnitude { x.num < 0 ? 0 - static_cast<std::uint64_t>(x.num) : static_cast<std::uint64_t>(x.num) };
+      const auto g { static_cast<std::int64_t>(euclidGcd(magnitude, static_cast<std::uint64_t>(x.den))) };
+
+      x = Calc::Rational { x.num / g, x.den / g };
+    }
+  }
+
+  double secondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  }
+
+  // x *= p/q, then x /= p/q, for random p/q; the exact result is x itself
+  double chain(const std::vector<Calc::Rational>& factors, int lazyBits, Calc::Rational& x, bool& ok) {
+    auto start { std::chrono::steady_clock::now() };
+    ok = true;
+
+    for (const Calc::Rational& f : factors)
+      ok = ok && Calc::multiply(x, f, x, lazyBits) && Calc::divide(x, f, x, lazyBits);
+
+    return secondsSince(start);
+  }
+}
+
+int main(int argc, char** argv) {
+  const std::size_t n { argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 4ull << 20 };
+
+  std::mt19937_64 rng { 11 };
+
+  // Both reduce through a gcd whose first operand is at or above 2^63: the
+  // sum, 15404570662242287227/160803960, is already in lowest terms (too
+  // big for 64 bits), the product reduces by 13 to 1369665677686961153/1152
+  Calc::Rational sum { }, product { };
+  const bool summed     { Calc::add({ 7702285331121143614, 160803960 }, { 7702285331121143613, 160803960 }, sum) };
+  const bool multiplied { Calc::multiply({ 1369665677686961153, 156 }, { 13, 96 }, product) };
+  const bool settled    { !summed && multiplied && product.num == 1369665677686961153 && product.den == 1152 };
+  const std::size_t wrongGcds { checkGcd(rng) };
+
+  std::cout << "binaryGcd vs std::gcd, 3M pairs" << (wrongGcds == 0 ? "" : "  [MISMATCH]") << '\n'
+            << "sum and product past 2^63"       << (settled        ? "" : "  [WRONG]")    << '\n';
+
+  // Random fractions sharing a random factor, up to ~2^62
+  std::vector<Calc::Rational> original(n);
+
+  for (Calc::Rational& x : original) {
+    const auto common { static_cast<std::int64_t>(rng() % (1u << 20)) + 1 };
+    x.num = static_cast<std::int64_t>(rng() >> 22) * common * (rng() & 1 ? 1 : -1);
+    x.den = (static_cast<std::int64_t>(rng() >> 22) + 1) * common;
+  }
+
+  std::vector<Calc::Rational> stein { original }, euclid { original };
+
+  auto start { std::chrono::steady_clock::now() };
+  Calc::reduceAll(stein);
+  const double steinSeconds { secondsSince(start) };
+
+  start = std::chrono::steady_clock::now();
+  reduceAllEuclid(euclid);
+  const double euclidSeconds { secondsSince(start) };
+
+  bool same { true };
+  for (std::size_t i { 0 }; i < n; ++i)
+    same = same && stein[i].num == euclid[i].num && stein[i].den == euclid[i].den;
+
+  std::cout << "reduce " << n << " fractions" << (same ? "" : "  [MISMATCH]") << '\n'
+            << "  stein (ctz):    " << n / steinSeconds / 1e6  << " M reductions/s\n"
+            << "  euclid (mod):   " << n / euclidSeconds / 1e6 << " M reductions/s\n";
+
+  std::vector<Calc::Rational> factors(n);
+  for (Calc::Rational& f : factors)
+    f = Calc::Rational { static_cast<std::int64_t>(rng() % 1000) + 1, static_cast<std::int64_t>(rng() % 1000) + 1 };
+
+  const Calc::Rational initial { 3, 7 };
+  std::cout << "multiply/divide chain of " << 2 * n << " operations\n";
+
+  for (int bits : { 0, 16, 32, 48 }) {
+    Calc::Rational x { initial };
+    bool ok { };
+    const double seconds { chain(factors, bits, x, ok) };
+
+    std::cout << "  lazyBits " << bits << (bits == 0 ? " (eager)" : "") << ":\t"
+              << 2 * n / seconds / 1e6 << " M ops/s"
+              << (ok && x == initial ? "" : "  [WRONG]") << '\n';
+  }
+
+  return 0;
+}
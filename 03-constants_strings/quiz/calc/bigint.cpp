@@ -0,0 +1,491 @@
+#include "bigint.h"
+
+#include <algorithm>
+#include <bit>
+
+namespace Calc {
+  namespace {
+    using Limb = BigInt::Limb;
+    using Mag  = std::vector<Limb>;
+    using u128 = unsigned __int128;
+
+    constexpr Limb        chunkBase   { 10'000'000'000'000'000'000ull }; // 10^19
+    constexpr std::size_t chunkDigits { 19 };
+    constexpr std::size_t leafLimbs   { 32 }; // below this, convert one chunk at a time
+
+    void trimMag(Mag& x) {
+      while (!x.empty() && x.back() == 0)
+        x.pop_back();
+    }
+
+    int compareMag(const Mag& a, const Mag& b) {
+      if (a.size() != b.size())
+        return a.size() < b.size() ? -1 : 1;
+
+      for (std::size_t i { a.size() }; i-- > 0; ) {
+        if (a[i] != b[i])
+          return a[i] < b[i] ? -1 : 1;
+      }
+
+      return 0;
+    }
+
+    Mag addMag(const Mag& a, const Mag& b) {
+      const Mag& big   { a.size() >= b.size() ? a : b };
+      const Mag& small { a.size() >= b.size() ? b : a };
+      Mag out(big.size() + 1);
+      Limb carry { 0 };
+
+      for (std::size_t i { 0 }; i < big.size(); ++i) {
+        const u128 s { static_cast<u128>(big[i]) + (i < small.size() ? small[i] : 0) + carry };
+        out[i] = static_cast<Limb>(s);
+        carry  = static_cast<Limb>(s >> 64);
+      }
+
+      out[big.size()] = carry;
+      trimMag(out);
+
+      return out;
+    }
+
+    // x -= y over x's n limbs; requires x >= y
+    void subtractInPlace(Limb* x, std::size_t n, const Limb* y, std::size_t ny) {
+      Limb borrow { 0 };
+
+      for (std::size_t i { 0 }; i < n && (i < ny || borrow); ++i) {
+        const Limb yi { i < ny ? y[i] : 0 };
+        const Limb d  { x[i] - yi };
+        const Limb b1 { x[i] < yi };
+
+        x[i]   = d - borrow;
+        borrow = b1 | (d < borrow);
+      }
+    }
+
+    // x += y at limb offset `at`, carrying through the rest of x
+    void addInPlace(Limb* x, std::size_t n, std::size_t at, const Limb* y, std::size_t ny) {
+      Limb carry { 0 };
+
+      for (std::size_t i { 0 }; at + i < n && (i < ny || carry); ++i) {
+        const u128 s { static_cast<u128>(x[at + i]) + (i < ny ? y[i] : 0) + carry };
+        x[at + i] = static_cast<Limb>(s);
+        carry     = static_cast<Limb>(s >> 64);
+      }
+    }
+
+    // out[0, na + nb) = a * b
+    void multiplySchool(const Limb* a, std::size_t na, const Limb* b, std::size_t nb, Limb* out) {
+      std::fill(out, out + na + nb, Limb { 0 });
+
+      for (std::size_t i { 0 }; i < na; ++i) {
+        Limb carry { 0 };
+
+        for (std::size_t j { 0 }; j < nb; ++j) {
+          const u128 t { static_cast<u128>(a[i]) * b[j] + out[i + j] + carry };
+          out[i + j] = static_cast<Limb>(t);
+          carry      = static_cast<Limb>(t >> 64);
+        }
+
+        out[i + nb] = carry;
+      }
+    }
+
+    // out[0, na + nb) = a * b, Karatsuba once both halves have threshold limbs
+    void multiplyInto(const Limb* a, std::size_t na, const Limb* b, std::size_t nb, Limb* out,
+                      std::size_t threshold) {
+      if (na < nb) {
+        std::swap(a, b);
+        std::swap(na, nb);
+      }
+
+      if (nb < std::max<std::size_t>(threshold, 2)) {
+        multiplySchool(a, na, b, nb, out);
+        return;
+      }
+
+      // Lopsided: multiply b by nb-limb slices of a, which are balanced
+      if (2 * nb <= na) {
+        std::fill(out, out + na + nb, Limb { 0 });
+        Mag slice(2 * nb);
+
+        for (std::size_t at { 0 }; at < na; at += nb) {
+          const std::size_t len { std::min(nb, na - at) };
+          multiplyInto(a + at, len, b, nb, slice.data(), threshold);
+          addInPlace(out, na + nb, at, slice.data(), len + nb);
+        }
+
+        return;
+      }
+
+      // a = a1 * B^k + a0, b = b1 * B^k + b0 (nb > na / 2 >= k, so b1 is nonempty)
+      const std::size_t k { na / 2 };
+
+      multiplyInto(a, k, b, k, out, threshold);                           // z0 -> out[0, 2k)
+      multiplyInto(a + k, na - k, b + k, nb - k, out + 2 * k, threshold); // z2 -> out[2k, na + nb)
+
+      const Mag a0(a, a + k), a1(a + k, a + na);
+      const Mag b0(b, b + k), b1(b + k, b + nb);
+      const Mag sa { addMag(a0, a1) };
+      const Mag sb { addMag(b0, b1) };
+
+      // z1 = (a0 + a1)(b0 + b1) - z0 - z2
+      Mag z1(sa.size() + sb.size() + 1);
+
+      if (!sa.empty() && !sb.empty())
+        multiplyInto(sa.data(), sa.size(), sb.data(), sb.size(), z1.data(), threshold);
+
+      subtractInPlace(z1.data(), z1.size(), out, 2 * k);
+      subtractInPlace(z1.data(), z1.size(), out + 2 * k, na + nb - 2 * k);
+      trimMag(z1);
+
+      addInPlace(out, na + nb, k, z1.data(), z1.size());
+    }
+
+    Mag multiplyMag(const Mag& a, const Mag& b, std::size_t threshold = karatsubaThreshold) {
+      if (a.empty() || b.empty())
+        return { };
+
+      Mag out(a.size() + b.size());
+      multiplyInto(a.data(), a.size(), b.data(), b.size(), out.data(), threshold);
+      trimMag(out);
+
+      return out;
+    }
+
+    // Returns the remainder; q = u / d
+    Limb divideShort(const Mag& u, Limb d, Mag& q) {
+      q.assign(u.size(), 0);
+      Limb rem { 0 };
+
+      for (std::size_t i { u.size() }; i-- > 0; ) {
+        const u128 num { (static_cast<u128>(rem) << 64) | u[i] };
+        q[i] = static_cast<Limb>(num / d);
+        rem  = static_cast<Limb>(num % d);
+      }
+
+      trimMag(q);
+      return rem;
+    }
+
+    // Knuth, TAOCP vol. 2, 4.3.1 algorithm D; v is nonempty
+    void divideMag(const Mag& u, const Mag& v, Mag& q, Mag& r) {
+      if (compareMag(u, v) < 0) {
+        q.clear();
+        r = u;
+        return;
+      }
+
+      if (v.size() == 1) {
+        const Limb rem { divideShort(u, v[0], q) };
+        r.clear();
+
+        if (rem)
+          r.push_back(rem);
+
+        return;
+      }
+
+      const std::size_t n { v.size() };
+      const std::size_t m { u.size() - n };
+      const int         s { __builtin_clzll(v.back()) };
+
+      // Normalize so the divisor's top bit is set
+      auto shifted { [s](Limb hi, Limb lo) { return s ? (hi << s) | (lo >> (64 - s)) : hi; } };
+
+      Mag vn(n), un(u.size() + 1);
+
+      for (std::size_t i { n - 1 }; i > 0; --i)
+        vn[i] = shifted(v[i], v[i - 1]);
+      vn[0] = v[0] << s;
+
+      un[u.size()] = s ? u.back() >> (64 - s) : 0;
+      for (std::size_t i { u.size() - 1 }; i > 0; --i)
+        un[i] = shifted(u[i], u[i - 1]);
+      un[0] = u[0] << s;
+
+      q.assign(m + 1, 0);
+
+      for (std::size_t j { m + 1 }; j-- > 0; ) {
+        const u128 num { (static_cast<u128>(un[j + n]) << 64) | un[j + n - 1] };
+        u128 qhat { num / vn[n - 1] };
+        u128 rhat { num % vn[n - 1] };
+
+        while ((qhat >> 64) || qhat * vn[n - 2] > ((rhat << 64) | un[j + n - 2])) {
+          --qhat;
+          rhat += vn[n - 1];
+
+          if (rhat >> 64)
+            break;
+        }
+
+        // un[j, j + n] -= qhat * vn
+        Limb carry { 0 }, borrow { 0 };
+
+        for (std::size_t i { 0 }; i < n; ++i) {
+          const u128 p  { qhat * vn[i] + carry };
+          const Limb lo { static_cast<Limb>(p) };
+          const Limb d  { un[i + j] - lo };
+
+          carry     = static_cast<Limb>(p >> 64);
+          const Limb b1 { un[i + j] < lo };
+          un[i + j] = d - borrow;
+          borrow    = b1 | (d < borrow);
+        }
+
+        const Limb d  { un[j + n] - carry };
+        const Limb b1 { un[j + n] < carry };
+        un[j + n] = d - borrow;
+
+        // qhat was one too large: add the divisor back
+        if (b1 | (d < borrow)) {
+          --qhat;
+          addInPlace(un.data(), j + n + 1, j, vn.data(), n);
+        }
+
+        q[j] = static_cast<Limb>(qhat);
+      }
+
+      r.assign(n, 0);
+
+      for (std::size_t i { 0 }; i < n; ++i)
+        r[i] = s ? (un[i] >> s) | (un[i + 1] << (64 - s)) : un[i];
+
+      trimMag(q);
+      trimMag(r);
+    }
+
+    // powers[k] = 10^(19 * 2^k) for k < count, each the square of the previous
+    std::vector<Mag> decimalPowers(std::size_t count) {
+      std::vector<Mag> powers { };
+
+      if (count > 0)
+        powers.push_back({ chunkBase });
+
+      while (powers.size() < count)
+        powers.push_back(multiplyMag(powers.back(), powers.back()));
+
+      return powers;
+    }
+
+    void appendChunk(std::string& out, Limb chunk, std::size_t width) {
+      char digits[chunkDigits];
+      std::size_t n { 0 };
+
+      do {
+        digits[n++] = static_cast<char>('0' + chunk % 10);
+        chunk /= 10;
+      } while (chunk);
+
+      out.append(width > n ? width - n : 0, '0');
+
+      while (n)
+        out.push_back(digits[--n]);
+    }
+
+    // Appends x in decimal, left-padded with zeros to `width` digits (0 = no padding)
+    void toDecimal(const Mag& x, std::size_t width, const std::vector<Mag>& powers, std::string& out) {
+      if (x.size() <= leafLimbs) {
+        std::vector<Limb> chunks { };
+        Mag rest { x }, q { };
+
+        while (!rest.empty()) {
+          chunks.push_back(divideShort(rest, chunkBase, q));
+          rest.swap(q);
+        }
+
+        std::string digits { chunks.empty() ? "0" : "" };
+
+        if (!chunks.empty())
+          appendChunk(digits, chunks.back(), 0);
+
+        for (std::size_t i { chunks.size() }; i-- > 1; )
+          appendChunk(digits, chunks[i - 1], chunkDigits);
+
+        out.append(width > digits.size() ? width - digits.size() : 0, '0');
+        out += digits;
+
+        return;
+      }
+
+      // Largest power with at most half of x's limbs
+      std::size_t k { 0 };
+
+      while (k + 1 < powers.size() && 2 * powers[k + 1].size() <= x.size() + 1)
+        ++k;
+
+      const std::size_t lowDigits { chunkDigits << k };
+      Mag high { }, low { };
+      divideMag(x, powers[k], high, low);
+
+      toDecimal(high, width > lowDigits ? width - lowDigits : 0, powers, out);
+      toDecimal(low, lowDigits, powers, out);
+    }
+
+    // digits[0, len) are all '0'..'9'
+    Mag fromDecimal(const char* digits, std::size_t len, const std::vector<Mag>& powers) {
+      if (len <= leafLimbs * chunkDigits) {
+        Mag x { };
+        std::size_t at { 0 };
+
+        while (at < len) {
+          const std::size_t take { at == 0 && len % chunkDigits ? len % chunkDigits : chunkDigits };
+          Limb chunk { 0 }, scale { 1 };
+
+          for (std::size_t i { 0 }; i < take; ++i) {
+            chunk = chunk * 10 + static_cast<Limb>(digits[at + i] - '0');
+            scale *= 10;
+          }
+
+          at += take;
+
+          // x = x * scale + chunk
+          Limb carry { chunk };
+
+          for (Limb& limb : x) {
+            const u128 t { static_cast<u128>(limb) * scale + carry };
+            limb  = static_cast<Limb>(t);
+            carry = static_cast<Limb>(t >> 64);
+          }
+
+          if (carry)
+            x.push_back(carry);
+        }
+
+        return x;
+      }
+
+      // Largest 19 * 2^k strictly below len
+      std::size_t k { 0 };
+
+      while ((chunkDigits << (k + 1)) < len)
+        ++k;
+
+      const std::size_t lowDigits { chunkDigits << k };
+      const Mag high { fromDecimal(digits, len - lowDigits, powers) };
+      const Mag low  { fromDecimal(digits + len - lowDigits, lowDigits, powers) };
+
+      return addMag(multiplyMag(high, powers[k]), low);
+    }
+  }
+
+  BigInt::BigInt(std::int64_t value) {
+    if (value == 0)
+      return;
+
+    m_negative = value < 0;
+    m_limbs.push_back(m_negative ? 0 - static_cast<Limb>(value) : static_cast<Limb>(value));
+  }
+
+  void BigInt::trim() {
+    trimMag(m_limbs);
+
+    if (m_limbs.empty())
+      m_negative = false;
+  }
+
+  bool BigInt::fromString(std::string_view text, BigInt& out) {
+    bool negative { false };
+
+    if (!text.empty() && (text[0] == '-' || text[0] == '+')) {
+      negative = text[0] == '-';
+      text.remove_prefix(1);
+    }
+
+    if (text.empty() || !std::all_of(text.begin(), text.end(), [](char c) { return c >= '0' && c <= '9'; }))
+      return false;
+
+    // fromDecimal splits at 19 * 2^k digits for the largest such k below the length
+    const std::vector<Mag> powers { decimalPowers(std::bit_width((text.size() - 1) / chunkDigits)) };
+
+    out.m_limbs    = fromDecimal(text.data(), text.size(), powers);
+    out.m_negative = negative;
+    out.trim();
+
+    return true;
+  }
+
+  std::string BigInt::toString() const {
+    // 10^(19 * 2^k) has about 2^k limbs, so this reaches half of m_limbs
+    const std::vector<Mag> powers { decimalPowers(m_limbs.size() > leafLimbs ? std::bit_width(m_limbs.size()) : 0) };
+
+    std::string out { m_negative ? "-" : "" };
+    toDecimal(m_limbs, 0, powers, out);
+
+    return out;
+  }
+
+  int compare(const BigInt& a, const BigInt& b) {
+    if (a.m_negative != b.m_negative)
+      return a.m_negative ? -1 : 1;
+
+    const int byMagnitude { compareMag(a.m_limbs, b.m_limbs) };
+    return a.m_negative ? -byMagnitude : byMagnitude;
+  }
+
+  BigInt operator-(const BigInt& a) {
+    BigInt out { a };
+    out.m_negative = !a.m_negative && !a.isZero();
+
+    return out;
+  }
+
+  BigInt operator+(const BigInt& a, const BigInt& b) {
+    BigInt out { };
+
+    if (a.m_negative == b.m_negative) {
+      out.m_limbs    = addMag(a.m_limbs, b.m_limbs);
+      out.m_negative = a.m_negative;
+    }
+
+    // Opposite signs: subtract the smaller magnitude from the larger
+    else if (compareMag(a.m_limbs, b.m_limbs) >= 0) {
+      out.m_limbs = a.m_limbs;
+      subtractInPlace(out.m_limbs.data(), out.m_limbs.size(), b.m_limbs.data(), b.m_limbs.size());
+      out.m_negative = a.m_negative;
+    }
+
+    else {
+      out.m_limbs = b.m_limbs;
+      subtractInPlace(out.m_limbs.data(), out.m_limbs.size(), a.m_limbs.data(), a.m_limbs.size());
+      out.m_negative = b.m_negative;
+    }
+
+    out.trim();
+    return out;
+  }
+
+  BigInt operator-(const BigInt& a, const BigInt& b) {
+    return a + -b;
+  }
+
+  BigInt operator*(const BigInt& a, const BigInt& b) {
+    return BigInt::multiply(a, b, karatsubaThreshold);
+  }
+
+  BigInt BigInt::multiply(const BigInt& a, const BigInt& b, std::size_t threshold) {
+    BigInt out { };
+    out.m_limbs    = multiplyMag(a.m_limbs, b.m_limbs, threshold);
+    out.m_negative = a.m_negative != b.m_negative;
+    out.trim();
+
+    return out;
+  }
+
+  bool BigInt::divmod(const BigInt& a, const BigInt& b, BigInt& quotient, BigInt& remainder) {
+    if (b.isZero())
+      return false;
+
+    Mag q { }, r { };
+    divideMag(a.m_limbs, b.m_limbs, q, r);
+
+    quotient.m_limbs     = std::move(q);
+    quotient.m_negative  = a.m_negative != b.m_negative;
+    remainder.m_limbs    = std::move(r);
+    remainder.m_negative = a.m_negative;
+
+    quotient.trim();
+    remainder.trim();
+
+    return true;
+  }
+}
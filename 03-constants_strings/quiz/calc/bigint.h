@@ -0,0 +1,65 @@
+// +--------------------------------------------+
+// |         ARBITRARY-PRECISION INTEGERS       |
+// +--------------------------------------------+
+//
+// Sign-magnitude integers on 64-bit limbs (least significant first, no
+// leading zero limbs; zero has no limbs and is never negative).
+//
+// Multiplication is schoolbook below karatsubaThreshold limbs and Karatsuba
+// above it. Division is Knuth's algorithm D and truncates toward zero like
+// int. Decimal conversion splits on 10^(19 * 2^k) in both directions, so
+// parsing runs at Karatsuba speed instead of one limb at a time.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace Calc {
+  // Smaller operand size (in limbs) where Karatsuba takes over; see bench_bigint
+  inline constexpr std::size_t karatsubaThreshold { 40 };
+
+  class BigInt {
+  public:
+    using Limb = std::uint64_t;
+
+    BigInt() = default;
+    BigInt(std::int64_t value);
+
+    // Optional sign followed by decimal digits; false on anything else
+    static bool fromString(std::string_view text, BigInt& out);
+    std::string toString() const;
+
+    bool isZero()     const { return m_limbs.empty(); }
+    bool isNegative() const { return m_negative; }
+
+    std::span<const Limb> limbs() const { return m_limbs; }
+
+    friend BigInt operator+(const BigInt& a, const BigInt& b);
+    friend BigInt operator-(const BigInt& a, const BigInt& b);
+    friend BigInt operator*(const BigInt& a, const BigInt& b);
+    friend BigInt operator-(const BigInt& a);
+
+    // a * b with a Karatsuba threshold other than karatsubaThreshold (for tuning)
+    static BigInt multiply(const BigInt& a, const BigInt& b, std::size_t threshold);
+
+    // -1, 0 or 1
+    friend int compare(const BigInt& a, const BigInt& b);
+
+    friend bool operator==(const BigInt& a, const BigInt& b) { return compare(a, b) == 0; }
+    friend bool operator<(const BigInt& a, const BigInt& b)  { return compare(a, b) < 0; }
+
+    // a = quotient * b + remainder, remainder has the sign of a; false when b is zero
+    static bool divmod(const BigInt& a, const BigInt& b, BigInt& quotient, BigInt& remainder);
+
+  private:
+    void trim();
+
+    std::vector<Limb> m_limbs    { };
+    bool              m_negative { false };
+  };
+}
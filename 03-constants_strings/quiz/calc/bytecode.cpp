@@ -0,0 +1,217 @@
+#include "bytecode.h"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <unordered_map>
+
+namespace Calc {
+  namespace {
+    enum class Opcode : std::uint8_t { add, subtract, multiply, divide, modulo, power, negate, ret };
+
+    // Runs threaded code on the register file r. Called with table != nullptr
+    // it only hands out its label addresses, which the compiler stores in
+    // ThreadedInstruction::handler (labels are local to this function).
+    double execute(const ThreadedInstruction* ip, double* r, const void* const** table) {
+      static const void* const labels[] {
+        &&add, &&subtract, &&multiply, &&divide, &&modulo, &&power, &&negate, &&ret
+      };
+
+      if (table) {
+        *table = labels;
+        return 0.0;
+      }
+
+      goto *ip->handler;
+
+    add:      r[ip->dst] = r[ip->a] + r[ip->b];            ++ip; goto *ip->handler;
+    subtract: r[ip->dst] = r[ip->a] - r[ip->b];            ++ip; goto *ip->handler;
+    multiply: r[ip->dst] = r[ip->a] * r[ip->b];            ++ip; goto *ip->handler;
+    divide:   r[ip->dst] = r[ip->a] / r[ip->b];            ++ip; goto *ip->handler;
+    modulo:   r[ip->dst] = std::fmod(r[ip->a], r[ip->b]);  ++ip; goto *ip->handler;
+    power:    r[ip->dst] = std::pow(r[ip->a], r[ip->b]);   ++ip; goto *ip->handler;
+    negate:   r[ip->dst] = -r[ip->a];                      ++ip; goto *ip->handler;
+    ret:      return r[ip->a];
+    }
+
+    double fold(Op op, double a, double b) {
+      switch (op) {
+        case Op::add:      return a + b;
+        case Op::subtract: return a - b;
+        case Op::multiply: return a * b;
+        case Op::divide:   return a / b;
+        case Op::modulo:   return std::fmod(a, b);
+        case Op::power:    return std::pow(a, b);
+        case Op::negate:   return -a;
+        default:           return 0.0;
+      }
+    }
+
+    Opcode opcodeFor(Op op) {
+      switch (op) {
+        case Op::add:      return Opcode::add;
+        case Op::subtract: return Opcode::subtract;
+        case Op::multiply: return Opcode::multiply;
+        case Op::divide:   return Opcode::divide;
+        case Op::modulo:   return Opcode::modulo;
+        case Op::power:    return Opcode::power;
+        default:           return Opcode::negate;
+      }
+    }
+
+    // Register references before layout is final: constants are
+    // encoded as -(index + 1) until the temporary count is known
+    struct Pending {
+      Opcode op  { };
+      int    dst { };
+      int    a   { };
+      int    b   { };
+    };
+
+    struct Operand {
+      bool   constant { };
+      double value    { };
+      int    reg      { };
+    };
+
+    class Compiler {
+    public:
+      explicit Compiler(const Expression& expr)
+        : m_expr { expr }, m_tempBase { static_cast<int>(expr.variables.size()) } { }
+
+      // Children come before parents (in the order recursive descent
+      // finishes them), so one pass in index order compiles the tree
+      // bottom-up with no recursion, however deep it is
+      void run() {
+        std::vector<Operand> operands(m_expr.nodes.size());
+
+        for (std::size_t i { 0 }; i < m_expr.nodes.size(); ++i)
+          operands[i] = compile(m_expr.nodes[i], operands);
+
+        const Operand result { operands[static_cast<std::size_t>(m_expr.root)] };
+        m_code.push_back(Pending { Opcode::ret, 0, materialize(result), 0 });
+      }
+
+      std::vector<Pending> m_code      { };
+      std::vector<double>  m_constants { };
+      int                  m_maxTemps  { 0 };
+
+    private:
+      // operands holds the result of every node before this one
+      Operand compile(const Node& node, const std::vector<Operand>& operands) {
+        if (node.op == Op::number)
+          return Operand { true, node.value, 0 };
+
+        if (node.op == Op::variable)
+          return Operand { false, 0.0, node.variable };
+
+        const Operand lhs { operands[static_cast<std::size_t>(node.lhs)] };
+        const Operand rhs { node.op == Op::negate ? Operand { true, 0.0, 0 } : operands[static_cast<std::size_t>(node.rhs)] };
+
+        if (lhs.constant && rhs.constant)
+          return Operand { true, fold(node.op, lhs.value, rhs.value), 0 };
+
+        const int a { materialize(lhs) };
+        const int b { node.op == Op::negate ? 0 : materialize(rhs) };
+
+        // Operands are read before dst is written, so dst may reuse their temps
+        if (node.op != Op::negate)
+          release(b);
+        release(a);
+
+        const int dst { allocate() };
+        m_code.push_back(Pending { opcodeFor(node.op), dst, a, b });
+
+        return Operand { false, 0.0, dst };
+      }
+
+      int materialize(const Operand& operand) {
+        if (!operand.constant)
+          return operand.reg;
+
+        // Keyed by bit pattern, so 0.0 and -0.0 stay apart and a long
+        // expression does not search the whole pool for every constant
+        const auto [found, inserted] {
+          m_constantIndex.try_emplace(std::bit_cast<std::uint64_t>(operand.value), static_cast<int>(m_constants.size()))
+        };
+
+        if (inserted)
+          m_constants.push_back(operand.value);
+
+        return -found->second - 1;
+      }
+
+      int allocate() {
+        const int reg { m_tempBase + m_temps++ };
+        m_maxTemps = std::max(m_maxTemps, m_temps);
+
+        return reg;
+      }
+
+      // Temporaries are freed in stack order
+      void release(int reg) {
+        if (reg >= m_tempBase && reg == m_tempBase + m_temps - 1)
+          --m_temps;
+      }
+
+      const Expression&                      m_expr;
+      const int                              m_tempBase;
+      int                                    m_temps         { 0 };
+      std::unordered_map<std::uint64_t, int> m_constantIndex { }; // bits -> index in m_constants
+    };
+  }
+
+  Bytecode::Bytecode(const Expression& expr)
+    : m_variableCount { expr.variables.size() } {
+    Compiler compiler { expr };
+    compiler.run();
+
+    m_constants     = compiler.m_constants;
+    m_constantBase  = m_variableCount + static_cast<std::size_t>(compiler.m_maxTemps);
+    m_registerCount = m_constantBase + m_constants.size();
+
+    if (m_registerCount > maxRegisters) {
+      m_error = ParseError { 0, "expression needs " + std::to_string(m_registerCount) + " registers, at most "
+                                + std::to_string(maxRegisters) + " fit the bytecode" };
+      return;
+    }
+
+    const void* const* labels { };
+    execute(nullptr, nullptr, &labels);
+
+    auto resolve = [&](int reg) {
+      return static_cast<std::uint16_t>(reg < 0 ? m_constantBase + static_cast<std::size_t>(-reg - 1)
+                                                : static_cast<std::size_t>(reg));
+    };
+
+    for (const Pending& p : compiler.m_code) {
+      m_code.push_back(ThreadedInstruction {
+        labels[static_cast<std::size_t>(p.op)], resolve(p.dst), resolve(p.a), resolve(p.b)
+      });
+    }
+  }
+
+  double Bytecode::run(std::span<const double> variables) const {
+    if (!valid() || variables.size() != m_variableCount)
+      return std::numeric_limits<double>::quiet_NaN();
+
+    std::array<double, 256> small;
+    std::vector<double>     large { };
+
+    double* regs { small.data() };
+
+    if (m_registerCount > small.size()) {
+      large.resize(m_registerCount);
+      regs = large.data();
+    }
+
+    std::memcpy(regs, variables.data(), m_variableCount * sizeof(double));
+    std::memcpy(regs + m_constantBase, m_constants.data(), m_constants.size() * sizeof(double));
+
+    return execute(m_code.data(), regs, nullptr);
+  }
+}
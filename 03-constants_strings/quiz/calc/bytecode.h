@@ -0,0 +1,62 @@
+// +--------------------------------------------+
+// |        REGISTER BYTECODE & THREADED VM     |
+// +--------------------------------------------+
+//
+// Compiles an Expression once, then evaluates it for many variable bindings.
+//
+// Register file: [0, V) variables, [V, V + T) temporaries, then constants.
+// Every instruction is three-address (dst = a op b) with 16-bit register
+// indexes, and constant subtrees are folded at compile time. An expression
+// that needs more than maxRegisters registers does not compile.
+//
+// Dispatch is direct threading: each instruction stores the address of its
+// handler (GCC/Clang "labels as values"), so moving to the next instruction is
+// one indirect jump, with no opcode decode and no switch.
+
+#pragma once
+
+#include "expression.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <vector>
+
+namespace Calc {
+  // Every register a 16-bit operand can name
+  inline constexpr std::size_t maxRegisters { std::size_t { std::numeric_limits<std::uint16_t>::max() } + 1 };
+
+  struct ThreadedInstruction {
+    const void*   handler { };
+    std::uint16_t dst     { };
+    std::uint16_t a       { };
+    std::uint16_t b       { };
+  };
+
+  class Bytecode {
+  public:
+    // Check valid(): too many registers fail compilation, and error() says
+    // how many were needed
+    explicit Bytecode(const Expression& expr);
+
+    bool valid() const              { return !m_code.empty(); }
+    const ParseError& error() const { return m_error; }
+
+    // variables[i] binds expr.variables[i]. NaN when the code is not valid()
+    // or variables.size() is not expr.variables.size().
+    double run(std::span<const double> variables) const;
+
+    std::size_t instructionCount() const { return m_code.size(); }
+    std::size_t registerCount() const    { return m_registerCount; }
+    std::size_t variableCount() const    { return m_variableCount; }
+
+  private:
+    ParseError                       m_error         { };
+    std::vector<ThreadedInstruction> m_code          { };
+    std::vector<double>              m_constants     { };
+    std::size_t                      m_variableCount { };
+    std::size_t                      m_constantBase  { };
+    std::size_t                      m_registerCount { };
+  };
+}
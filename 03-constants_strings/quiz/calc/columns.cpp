@@ -0,0 +1,292 @@
+#include "columns.h"
+
+#include "../../../common/checked.h"
+#include "../../../common/int_parse.h"
+
+#include <charconv>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+
+#if defined(__x86_64__) || defined(__i386__)
+  #include <immintrin.h>
+  #define CALC_X86 1
+#endif
+
+namespace Calc {
+  namespace {
+    constexpr double quietNaN { std::numeric_limits<double>::quiet_NaN() };
+
+    void divideScalar(const std::int32_t* a, const std::int32_t* b, double* out,
+                      std::size_t begin, std::size_t n, std::vector<std::size_t>& zeroRows) {
+      for (std::size_t i { begin }; i < n; ++i) {
+        if (b[i] == 0) {
+          out[i] = quietNaN;
+          zeroRows.push_back(i);
+        }
+
+        else {
+          out[i] = static_cast<double>(a[i]) / static_cast<double>(b[i]);
+        }
+      }
+    }
+
+    // Records the rows of the set bits in a lane mask
+    void recordZeros(unsigned mask, std::size_t row, std::vector<std::size_t>& zeroRows) {
+      while (mask) {
+        zeroRows.push_back(row + static_cast<std::size_t>(__builtin_ctz(mask)));
+        mask &= mask - 1;
+      }
+    }
+
+#ifdef CALC_X86
+    __attribute__((target("avx2")))
+    std::size_t divideAvx2(const std::int32_t* a, const std::int32_t* b, double* out,
+                           std::size_t n, std::vector<std::size_t>& zeroRows) {
+      const __m256d nan { _mm256_set1_pd(quietNaN) };
+      std::size_t i { 0 };
+
+      for (; i + 4 <= n; i += 4) {
+        const __m128i va { _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i)) };
+        const __m128i vb { _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i)) };
+        const __m128i zero { _mm_cmpeq_epi32(vb, _mm_setzero_si128()) };
+
+        // int32 -> double is exact, so the quotient rounds only once
+        __m256d q { _mm256_div_pd(_mm256_cvtepi32_pd(va), _mm256_cvtepi32_pd(vb)) };
+
+        if (const unsigned mask { static_cast<unsigned>(_mm_movemask_ps(_mm_castsi128_ps(zero))) }) {
+          q = _mm256_blendv_pd(q, nan, _mm256_castsi256_pd(_mm256_cvtepi32_epi64(zero)));
+          recordZeros(mask, i, zeroRows);
+        }
+
+        _mm256_storeu_pd(out + i, q);
+      }
+
+      return i;
+    }
+
+    __attribute__((target("sse4.1")))
+    std::size_t divideSse41(const std::int32_t* a, const std::int32_t* b, double* out,
+                            std::size_t n, std::vector<std::size_t>& zeroRows) {
+      const __m128d nan { _mm_set1_pd(quietNaN) };
+      std::size_t i { 0 };
+
+      for (; i + 4 <= n; i += 4) {
+        const __m128i va   { _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i)) };
+        const __m128i vb   { _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i)) };
+        const __m128i zero { _mm_cmpeq_epi32(vb, _mm_setzero_si128()) };
+
+        const __m128i vaHigh { _mm_unpackhi_epi64(va, va) };
+        const __m128i vbHigh { _mm_unpackhi_epi64(vb, vb) };
+
+        __m128d low  { _mm_div_pd(_mm_cvtepi32_pd(va), _mm_cvtepi32_pd(vb)) };
+        __m128d high { _mm_div_pd(_mm_cvtepi32_pd(vaHigh), _mm_cvtepi32_pd(vbHigh)) };
+
+        if (const unsigned mask { static_cast<unsigned>(_mm_movemask_ps(_mm_castsi128_ps(zero))) }) {
+          low  = _mm_blendv_pd(low,  nan, _mm_castsi128_pd(_mm_cvtepi32_epi64(zero)));
+          high = _mm_blendv_pd(high, nan, _mm_castsi128_pd(_mm_cvtepi32_epi64(_mm_unpackhi_epi64(zero, zero))));
+          recordZeros(mask, i, zeroRows);
+        }
+
+        _mm_storeu_pd(out + i,     low);
+        _mm_storeu_pd(out + i + 2, high);
+      }
+
+      return i;
+    }
+#endif
+
+    // Skips spaces and tabs (not newlines)
+    const char* skipBlanks(const char* p, const char* end) {
+      while (p < end && (*p == ' ' || *p == '\t' || *p == '\r'))
+        ++p;
+
+      return p;
+    }
+  }
+
+  Isa detectIsa() {
+#ifdef CALC_X86
+    static const Isa best {
+      __builtin_cpu_supports("avx2")   ? Isa::avx2
+    : __builtin_cpu_supports("sse4.1") ? Isa::sse41
+    :                                    Isa::scalar
+    };
+
+    return best;
+#else
+    return Isa::scalar;
+#endif
+  }
+
+  const char* isaName(Isa isa) {
+    switch (isa) {
+      case Isa::avx2:  return "avx2";
+      case Isa::sse41: return "sse4.1";
+      default:         return "scalar";
+    }
+  }
+
+  std::size_t applyIntegers(Operation op, const std::int32_t* a, const std::int32_t* b,
+                            std::int32_t* out, std::size_t n, Isa isa) {
+    const Checked::Op checkedOp {
+      op == Operation::add      ? Checked::Op::add
+    : op == Operation::subtract ? Checked::Op::subtract
+    :                             Checked::Op::multiply
+    };
+
+    // Overflow checks need AVX2 to pay off, so SSE4.1 runs the scalar kernel
+    const Checked::Kernel kernel { isa == Isa::avx2 ? Checked::Kernel::avx2 : Checked::Kernel::scalar };
+
+    return Checked::apply<Checked::Report>(checkedOp, a, b, out, n, kernel);
+  }
+
+  void divideColumns(const std::int32_t* a, const std::int32_t* b, double* out, std::size_t n,
+                     std::vector<std::size_t>& zeroRows, Isa isa) {
+    std::size_t done { 0 };
+
+#ifdef CALC_X86
+    if (isa == Isa::avx2)
+      done = divideAvx2(a, b, out, n, zeroRows);
+    else if (isa == Isa::sse41)
+      done = divideSse41(a, b, out, n, zeroRows);
+#endif
+
+    divideScalar(a, b, out, done, n, zeroRows);
+  }
+
+  BatchResult runBatch(Operation op, const Columns& columns, Isa isa) {
+    BatchResult result { };
+    const std::size_t n { columns.a.size() };
+
+    if (op == Operation::divide) {
+      result.quotients.resize(n);
+      divideColumns(columns.a.data(), columns.b.data(), result.quotients.data(), n, result.divideByZero, isa);
+    }
+
+    else {
+      result.integers.resize(n);
+
+      if (const std::size_t row { applyIntegers(op, columns.a.data(), columns.b.data(), result.integers.data(), n, isa) }; row < n)
+        result.overflow = row;
+    }
+
+    return result;
+  }
+
+  bool readColumns(const std::string& path, Columns& out, std::string& error) {
+    std::FILE* file { std::fopen(path.c_str(), "rb") };
+
+    if (!file) {
+      error = "cannot open " + path;
+      return false;
+    }
+
+    std::string text { };
+    char chunk[1 << 16];
+
+    for (std::size_t got; (got = std::fread(chunk, 1, sizeof(chunk), file)) > 0; )
+      text.append(chunk, got);
+
+    std::fclose(file);
+
+    out.a.clear();
+    out.b.clear();
+
+    const char* p   { text.data() };
+    const char* end { text.data() + text.size() };
+    std::size_t line { 1 };
+
+    while (p < end) {
+      p = skipBlanks(p, end);
+
+      // Blank lines are allowed
+      if (p < end && *p == '\n') {
+        ++p;
+        ++line;
+        continue;
+      }
+
+      if (p == end)
+        break;
+
+      // Columns are numbered from 1: the first bad character, or the start
+      // of a number that does not fit
+      const char* lineStart { p };
+      const char* number    { p };
+      std::int32_t a { }, b { };
+      IntParse::Result field { IntParse::parse(p, end, a) };
+
+      if (field) {
+        p = number = skipBlanks(field.ptr, end);
+        field = IntParse::parse(p, end, b);
+      }
+
+      if (field) {
+        p = skipBlanks(field.ptr, end);
+
+        if (p < end && *p != '\n')
+          field = IntParse::Result { p, IntParse::Error::invalidCharacter };
+      }
+
+      if (!field) {
+        const char* at { field.error == IntParse::Error::overflow ? number : field.ptr };
+
+        while (lineStart > text.data() && lineStart[-1] != '\n')
+          --lineStart;
+
+        error = "line " + std::to_string(line) + ", column " + std::to_string(at - lineStart + 1)
+              + ": " + IntParse::describe(field.error) + " (expected two integers)";
+        return false;
+      }
+
+      out.a.push_back(a);
+      out.b.push_back(b);
+    }
+
+    return true;
+  }
+
+  bool writeResult(const std::string& path, Operation op, const BatchResult& result) {
+    std::FILE* file { std::fopen(path.c_str(), "wb") };
+
+    if (!file)
+      return false;
+
+    std::vector<char> buffer(1 << 20);
+    std::size_t used { 0 };
+    bool ok { true };
+
+    const std::size_t rows { op == Operation::divide ? result.quotients.size() : result.integers.size() };
+
+    for (std::size_t i { 0 }; i < rows && ok; ++i) {
+      if (buffer.size() - used < 64) {
+        ok = std::fwrite(buffer.data(), 1, used, file) == used;
+        used = 0;
+      }
+
+      char* at  { buffer.data() + used };
+      char* end { buffer.data() + buffer.size() };
+
+      if (op != Operation::divide) {
+        at = std::to_chars(at, end, result.integers[i]).ptr;
+      }
+
+      else if (result.quotients[i] != result.quotients[i]) {
+        std::memcpy(at, "nan", 3);
+        at += 3;
+      }
+
+      else {
+        at = std::to_chars(at, end, result.quotients[i]).ptr;
+      }
+
+      *at++ = '\n';
+      used = static_cast<std::size_t>(at - buffer.data());
+    }
+
+    ok = ok && std::fwrite(buffer.data(), 1, used, file) == used;
+
+    return std::fclose(file) == 0 && ok;
+  }
+}
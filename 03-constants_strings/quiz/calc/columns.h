@@ -0,0 +1,89 @@
+// +--------------------------------------------+
+// |          COLUMNAR BATCH CALCULATOR         |
+// +--------------------------------------------+
+//
+// Batch version of the calculator: two columns of ints from a text file
+// ("a b" per line) go into 64-byte aligned arrays. One operation runs over
+// every row with the widest kernel this CPU supports (AVX2, SSE4.1 or scalar,
+// chosen at runtime), and the result column is written back out.
+//
+// Add, subtract and multiply go through Checked::apply<Checked::Report>, so a
+// result that does not fit in an int is caught and the first such row is
+// reported instead of wrapping silently. Division yields doubles, so nothing
+// is truncated. A row with a zero divisor gets NaN and its index is reported.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace Calc {
+  template <typename T, std::size_t Alignment = 64>
+  struct AlignedAllocator {
+    using value_type = T;
+
+    template <typename U>
+    struct rebind { using other = AlignedAllocator<U, Alignment>; };
+
+    AlignedAllocator() = default;
+
+    template <typename U>
+    AlignedAllocator(const AlignedAllocator<U, Alignment>&) { }
+
+    T* allocate(std::size_t n) {
+      const std::size_t bytes { (n * sizeof(T) + Alignment - 1) / Alignment * Alignment };
+
+      if (void* p { std::aligned_alloc(Alignment, bytes) })
+        return static_cast<T*>(p);
+
+      throw std::bad_alloc { };
+    }
+
+    void deallocate(T* p, std::size_t) { std::free(p); }
+
+    template <typename U>
+    bool operator==(const AlignedAllocator<U, Alignment>&) const { return true; }
+  };
+
+  template <typename T>
+  using AlignedVector = std::vector<T, AlignedAllocator<T>>;
+
+  // Same numbering as the calculator menu
+  enum class Operation { add = 1, subtract = 2, divide = 3, multiply = 4 };
+
+  enum class Isa { scalar, sse41, avx2 };
+
+  // Best instruction set available on this machine
+  Isa detectIsa();
+  const char* isaName(Isa isa);
+
+  struct Columns {
+    AlignedVector<std::int32_t> a { };
+    AlignedVector<std::int32_t> b { };
+  };
+
+  struct BatchResult {
+    AlignedVector<std::int32_t> integers      { }; // add, subtract, multiply
+    AlignedVector<double>       quotients     { }; // divide
+    std::vector<std::size_t>    divideByZero  { }; // rows whose divisor is 0, ascending
+    std::optional<std::size_t>  overflow      { }; // first row whose result does not fit in an int
+  };
+
+  // Returns false and sets `error` (with line and column) on unreadable input
+  bool readColumns(const std::string& path, Columns& out, std::string& error);
+  bool writeResult(const std::string& path, Operation op, const BatchResult& result);
+
+  // Element-wise kernels; out must hold n values. applyIntegers returns the
+  // first row that overflowed (its value wrapped), or n if none did
+  std::size_t applyIntegers(Operation op, const std::int32_t* a, const std::int32_t* b,
+                            std::int32_t* out, std::size_t n, Isa isa = detectIsa());
+  void divideColumns(const std::int32_t* a, const std::int32_t* b, double* out, std::size_t n,
+                     std::vector<std::size_t>& zeroRows, Isa isa = detectIsa());
+
+  BatchResult runBatch(Operation op, const Columns& columns, Isa isa = detectIsa());
+}
@@ -0,0 +1,237 @@
+#include "expression.h"
+
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <cmath>
+
+namespace Calc {
+  namespace {
+    // Every level of parentheses, unary minus or '^' is a few stack frames
+    // of recursive descent; past this many, parsing stops with an error
+    constexpr int maxNesting { 1000 };
+
+    class Parser {
+    public:
+      Parser(std::string_view source, Expression& out, ParseError& error)
+        : m_source { source }, m_out { out }, m_error { error } { }
+
+      bool run() {
+        m_out = Expression { };
+        m_out.root = expr();
+
+        if (m_failed)
+          return false;
+
+        skipSpaces();
+
+        if (m_pos != m_source.size()) {
+          fail("unexpected character");
+          return false;
+        }
+
+        return true;
+      }
+
+    private:
+      int expr() {
+        int lhs { term() };
+
+        while (!m_failed) {
+          if (accept('+'))
+            lhs = add(Op::add, lhs, term());
+          else if (accept('-'))
+            lhs = add(Op::subtract, lhs, term());
+          else
+            break;
+        }
+
+        return lhs;
+      }
+
+      int term() {
+        int lhs { unary() };
+
+        while (!m_failed) {
+          if (accept('*'))
+            lhs = add(Op::multiply, lhs, unary());
+          else if (accept('/'))
+            lhs = add(Op::divide, lhs, unary());
+          else if (accept('%'))
+            lhs = add(Op::modulo, lhs, unary());
+          else
+            break;
+        }
+
+        return lhs;
+      }
+
+      // Every recursion of the grammar passes through here
+      int unary() {
+        if (m_depth == maxNesting)
+          return fail("expression nested too deeply");
+
+        ++m_depth;
+        const int node { accept('-') ? add(Op::negate, unary(), -1) : power() };
+        --m_depth;
+
+        return node;
+      }
+
+      int power() {
+        int base { primary() };
+
+        if (!m_failed && accept('^'))
+          return add(Op::power, base, unary());
+
+        return base;
+      }
+
+      int primary() {
+        skipSpaces();
+
+        if (m_failed)
+          return -1;
+
+        if (m_pos >= m_source.size())
+          return fail("expected a number, name or '('");
+
+        const char c { m_source[m_pos] };
+
+        if (c == '(') {
+          ++m_pos;
+          int inner { expr() };
+
+          if (!m_failed && !accept(')'))
+            return fail("expected ')'");
+
+          return inner;
+        }
+
+        if (std::isdigit(static_cast<unsigned char>(c)) || c == '.') {
+          Node node { };
+          auto [end, ec] { std::from_chars(m_source.data() + m_pos, m_source.data() + m_source.size(), node.value) };
+
+          if (ec != std::errc { })
+            return fail("malformed number");
+
+          m_pos = static_cast<std::size_t>(end - m_source.data());
+          m_out.nodes.push_back(node);
+
+          return static_cast<int>(m_out.nodes.size()) - 1;
+        }
+
+        if (std::isalpha(static_cast<unsigned char>(c)) || c == '_') {
+          const std::size_t start { m_pos };
+
+          while (m_pos < m_source.size()
+                 && (std::isalnum(static_cast<unsigned char>(m_source[m_pos])) || m_source[m_pos] == '_'))
+            ++m_pos;
+
+          const std::string name { m_source.substr(start, m_pos - start) };
+          auto& names { m_out.variables };
+          auto found { std::find(names.begin(), names.end(), name) };
+
+          if (found == names.end())
+            found = names.insert(names.end(), name);
+
+          Node node { };
+          node.op       = Op::variable;
+          node.variable = static_cast<int>(found - names.begin());
+          m_out.nodes.push_back(node);
+
+          return static_cast<int>(m_out.nodes.size()) - 1;
+        }
+
+        return fail("expected a number, name or '('");
+      }
+
+      int add(Op op, int lhs, int rhs) {
+        if (m_failed)
+          return -1;
+
+        Node node { };
+        node.op  = op;
+        node.lhs = lhs;
+        node.rhs = rhs;
+        m_out.nodes.push_back(node);
+
+        return static_cast<int>(m_out.nodes.size()) - 1;
+      }
+
+      bool accept(char c) {
+        skipSpaces();
+
+        if (m_pos < m_source.size() && m_source[m_pos] == c) {
+          ++m_pos;
+          return true;
+        }
+
+        return false;
+      }
+
+      void skipSpaces() {
+        while (m_pos < m_source.size() && std::isspace(static_cast<unsigned char>(m_source[m_pos])))
+          ++m_pos;
+      }
+
+      // Records the first error; returns an invalid node index
+      int fail(const char* message) {
+        if (!m_failed) {
+          m_failed = true;
+          m_error  = ParseError { m_pos, message };
+        }
+
+        return -1;
+      }
+
+      std::string_view m_source;
+      Expression&      m_out;
+      ParseError&      m_error;
+      std::size_t      m_pos    { 0 };
+      int              m_depth  { 0 };
+      bool             m_failed { false };
+    };
+
+    double apply(Op op, double a, double b) {
+      switch (op) {
+        case Op::negate:   return -a;
+        case Op::add:      return a + b;
+        case Op::subtract: return a - b;
+        case Op::multiply: return a * b;
+        case Op::divide:   return a / b;
+        case Op::modulo:   return std::fmod(a, b);
+        case Op::power:    return std::pow(a, b);
+        default:           return 0.0;
+      }
+    }
+  }
+
+  bool parse(std::string_view source, Expression& out, ParseError& error) {
+    return Parser { source, out, error }.run();
+  }
+
+  // Children come before parents, so one pass in index order sees every
+  // operand before its operator, however deep the tree is
+  double evaluateTree(const Expression& expr, std::span<const double> variables) {
+    // Reused between calls, so evaluating does not allocate
+    thread_local std::vector<double> values { };
+
+    if (values.size() < expr.nodes.size())
+      values.resize(expr.nodes.size());
+
+    for (std::size_t i { 0 }; i < expr.nodes.size(); ++i) {
+      const Node& node { expr.nodes[i] };
+
+      if (node.op == Op::number)
+        values[i] = node.value;
+      else if (node.op == Op::variable)
+        values[i] = variables[static_cast<std::size_t>(node.variable)];
+      else
+        values[i] = apply(node.op, values[static_cast<std::size_t>(node.lhs)],
+                          node.op == Op::negate ? 0.0 : values[static_cast<std::size_t>(node.rhs)]);
+    }
+
+    return values[static_cast<std::size_t>(expr.root)];
+  }
+}
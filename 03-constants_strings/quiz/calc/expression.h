@@ -0,0 +1,52 @@
+// +--------------------------------------------+
+// |            EXPRESSION PARSER (AST)         |
+// +--------------------------------------------+
+//
+// Parses arithmetic like "(x + 3) * y ^ 2 - 1.5e3 / z" into a flat tree.
+//
+//   expr    = term   { ('+' | '-') term }
+//   term    = unary  { ('*' | '/' | '%') unary }
+//   unary   = '-' unary | power
+//   power   = primary [ '^' unary ]          (right associative)
+//   primary = number | name | '(' expr ')'
+//
+// Names are variables; their values are supplied at evaluation time,
+// indexed in order of first appearance. Parentheses, unary minus and '^'
+// may nest up to 1000 deep; a chain of '+' or '*' may be any length.
+
+#pragma once
+
+#include <cstddef>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace Calc {
+  enum class Op { number, variable, negate, add, subtract, multiply, divide, modulo, power };
+
+  struct Node {
+    Op     op       { Op::number };
+    double value    { };  // Op::number
+    int    variable { };  // Op::variable
+    int    lhs      { -1 };
+    int    rhs      { -1 };
+  };
+
+  struct Expression {
+    std::vector<Node>        nodes     { }; // children always come before parents
+    int                      root      { -1 };
+    std::vector<std::string> variables { };
+  };
+
+  struct ParseError {
+    std::size_t position { };
+    std::string message  { };
+  };
+
+  // Returns false and fills `error` when the source is not a valid expression
+  bool parse(std::string_view source, Expression& out, ParseError& error);
+
+  // Reference evaluator: one pass over the nodes, children first
+  double evaluateTree(const Expression& expr, std::span<const double> variables);
+}
@@ -0,0 +1,339 @@
+#include "jit.h"
+
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <unordered_map>
+#include <vector>
+
+#include <sys/mman.h>
+
+namespace Calc {
+  namespace {
+    constexpr int maxDepth   { 16 };            // xmm0..xmm15
+    constexpr int frameBytes { maxDepth * 8 };  // spill slots, keeps rsp 16-aligned
+
+    class Emitter {
+    public:
+      explicit Emitter(const Expression& expr)
+        : m_expr { expr } { }
+
+      bool run() {
+        prologue();
+
+        if (!compile())
+          return false;
+
+        epilogue();
+        layoutPool();
+
+        return true;
+      }
+
+      const std::vector<std::uint8_t>& bytes() const { return m_code; }
+
+    private:
+      struct Folded {
+        bool   constant { false }; // the whole subtree is constant
+        bool   inside   { false }; // part of a constant parent, emits nothing
+        double value    { };
+      };
+
+      // Children come before parents, in the order recursive descent
+      // finishes them. One pass folds constant subtrees; a second emits
+      // code in index order, so no step recurses and none rescans a
+      // subtree. Each node leaves its value in xmm(depth) and bumps depth.
+      bool compile() {
+        const std::vector<Node>& nodes { m_expr.nodes };
+        std::vector<Folded> folded(nodes.size());
+
+        for (std::size_t i { 0 }; i < nodes.size(); ++i) {
+          const Node& node { nodes[i] };
+
+          if (node.op == Op::number) {
+            folded[i] = Folded { true, false, node.value };
+            continue;
+          }
+
+          if (node.op == Op::variable)
+            continue;
+
+          Folded&       lhs { folded[static_cast<std::size_t>(node.lhs)] };
+          Folded* const rhs { node.op == Op::negate ? nullptr : &folded[static_cast<std::size_t>(node.rhs)] };
+
+          if (!lhs.constant || (rhs && !rhs->constant))
+            continue;
+
+          folded[i] = Folded { true, false, fold(node.op, lhs.value, rhs ? rhs->value : 0.0) };
+          lhs.inside = true;
+
+          if (rhs)
+            rhs->inside = true;
+        }
+
+        for (std::size_t i { 0 }; i < nodes.size(); ++i) {
+          const Node& node { nodes[i] };
+
+          if (folded[i].inside)
+            continue;
+
+          if (folded[i].constant || node.op == Op::variable) {
+            if (m_depth >= maxDepth)
+              return false;
+
+            if (folded[i].constant)
+              loadConstant(m_depth++, folded[i].value);
+            else
+              loadVariable(m_depth++, node.variable);
+
+            continue;
+          }
+
+          if (node.op == Op::negate) {
+            xorSignMask(m_depth - 1);
+            continue;
+          }
+
+          const int dst { m_depth - 2 };
+          const int src { m_depth - 1 };
+
+          switch (node.op) {
+            case Op::add:      sse(0xF2, 0x58, dst, src); break;
+            case Op::subtract: sse(0xF2, 0x5C, dst, src); break;
+            case Op::multiply: sse(0xF2, 0x59, dst, src); break;
+            case Op::divide:   sse(0xF2, 0x5E, dst, src); break;
+            case Op::modulo:   callBinary(reinterpret_cast<const void*>(static_cast<double (*)(double, double)>(std::fmod))); break;
+            case Op::power:    callBinary(reinterpret_cast<const void*>(static_cast<double (*)(double, double)>(std::pow)));  break;
+            default:           return false;
+          }
+
+          --m_depth;
+        }
+
+        return true;
+      }
+
+      static double fold(Op op, double a, double b) {
+        switch (op) {
+          case Op::negate:   return -a;
+          case Op::add:      return a + b;
+          case Op::subtract: return a - b;
+          case Op::multiply: return a * b;
+          case Op::divide:   return a / b;
+          case Op::modulo:   return std::fmod(a, b);
+          default:           return std::pow(a, b);
+        }
+      }
+
+      // -- Encoding helpers --
+      void byte(std::uint8_t b) { m_code.push_back(b); }
+
+      void dword(std::uint32_t v) {
+        for (int i { 0 }; i < 4; ++i)
+          byte(static_cast<std::uint8_t>(v >> (8 * i)));
+      }
+
+      void qword(std::uint64_t v) {
+        for (int i { 0 }; i < 8; ++i)
+          byte(static_cast<std::uint8_t>(v >> (8 * i)));
+      }
+
+      static std::uint8_t modrm(int mod, int reg, int rm) {
+        return static_cast<std::uint8_t>((mod << 6) | ((reg & 7) << 3) | (rm & 7));
+      }
+
+      // Optional REX for xmm8..xmm15 in the reg (R) or rm (B) field
+      void rex(int reg, int rm) {
+        if (reg >= 8 || rm >= 8)
+          byte(static_cast<std::uint8_t>(0x40 | ((reg >= 8) << 2) | (rm >= 8)));
+      }
+
+      // prefix 0F op, xmm(reg), xmm(rm)
+      void sse(std::uint8_t prefix, std::uint8_t op, int reg, int rm) {
+        byte(prefix);
+        rex(reg, rm);
+        byte(0x0F);
+        byte(op);
+        byte(modrm(3, reg, rm));
+      }
+
+      // movsd xmm, [rbx + 8 * variable]
+      void loadVariable(int reg, int variable) {
+        byte(0xF2);
+        rex(reg, 0);
+        byte(0x0F);
+        byte(0x10);
+        byte(modrm(2, reg, 3));
+        dword(static_cast<std::uint32_t>(variable * 8));
+      }
+
+      // movsd xmm, [rip + constant]
+      void loadConstant(int reg, double value) {
+        byte(0xF2);
+        rex(reg, 0);
+        byte(0x0F);
+        byte(0x10);
+        byte(modrm(0, reg, 5));
+        fixup(constantSlot(value));
+      }
+
+      // xorpd xmm, [rip + sign mask] (the mask is 16-byte aligned)
+      void xorSignMask(int reg) {
+        byte(0x66);
+        rex(reg, 0);
+        byte(0x0F);
+        byte(0x57);
+        byte(modrm(0, reg, 5));
+        fixup(-1);
+      }
+
+      // movsd [rsp + 8 * slot], xmm   /   movsd xmm, [rsp + 8 * slot]
+      void spill(int reg, bool store) {
+        byte(0xF2);
+        rex(reg, 0);
+        byte(0x0F);
+        byte(store ? 0x11 : 0x10);
+        byte(modrm(2, reg, 4));
+        byte(0x24);
+        dword(static_cast<std::uint32_t>(reg * 8));
+      }
+
+      // xmm(d-2) = f(xmm(d-2), xmm(d-1)); every xmm register is caller-saved
+      void callBinary(const void* function) {
+        const int lhs { m_depth - 2 };
+        const int rhs { m_depth - 1 };
+
+        for (int r { 0 }; r < lhs; ++r)
+          spill(r, true);
+
+        if (lhs != 0)
+          sse(0xF2, 0x10, 0, lhs);
+        if (rhs != 1)
+          sse(0xF2, 0x10, 1, rhs);
+
+        byte(0x48); byte(0xB8);                 // mov rax, imm64
+        qword(reinterpret_cast<std::uint64_t>(function));
+        byte(0xFF); byte(0xD0);                 // call rax
+
+        if (lhs != 0)
+          sse(0xF2, 0x10, lhs, 0);
+
+        for (int r { 0 }; r < lhs; ++r)
+          spill(r, false);
+      }
+
+      void prologue() {
+        byte(0x53);                             // push rbx
+        byte(0x48); byte(0x89); byte(0xFB);     // mov rbx, rdi
+        byte(0x48); byte(0x81); byte(0xEC);     // sub rsp, frame
+        dword(frameBytes);
+      }
+
+      void epilogue() {
+        byte(0x48); byte(0x81); byte(0xC4);     // add rsp, frame
+        dword(frameBytes);
+        byte(0x5B);                             // pop rbx
+        byte(0xC3);                             // ret
+      }
+
+      // -- Constant pool --
+      // Keyed by bit pattern, like the bytecode's pool
+      int constantSlot(double value) {
+        const auto [found, inserted] {
+          m_constantSlots.try_emplace(std::bit_cast<std::uint64_t>(value), static_cast<int>(m_constants.size()))
+        };
+
+        if (inserted)
+          m_constants.push_back(value);
+
+        return found->second;
+      }
+
+      // Reserves a rel32 to be patched once the pool's address is known;
+      // slot -1 is the sign mask
+      void fixup(int slot) {
+        m_fixups.push_back({ m_code.size(), slot });
+        dword(0);
+      }
+
+      void layoutPool() {
+        while (m_code.size() % 16)
+          byte(0xCC);
+
+        const std::size_t maskAt { m_code.size() };
+        qword(0x8000'0000'0000'0000ull);
+        qword(0x8000'0000'0000'0000ull);
+
+        const std::size_t constantsAt { m_code.size() };
+        for (double c : m_constants) {
+          std::uint64_t bits { };
+          std::memcpy(&bits, &c, sizeof(bits));
+          qword(bits);
+        }
+
+        for (const auto& [at, slot] : m_fixups) {
+          const std::size_t target { slot < 0 ? maskAt : constantsAt + 8 * static_cast<std::size_t>(slot) };
+          const auto rel { static_cast<std::int32_t>(static_cast<std::int64_t>(target) - static_cast<std::int64_t>(at + 4)) };
+          std::memcpy(&m_code[at], &rel, sizeof(rel));
+        }
+      }
+
+      struct Fixup {
+        std::size_t at   { };
+        int         slot { };
+      };
+
+      const Expression&                      m_expr;
+      std::vector<std::uint8_t>              m_code          { };
+      std::vector<double>                    m_constants     { };
+      std::unordered_map<std::uint64_t, int> m_constantSlots { }; // bits -> index in m_constants
+      std::vector<Fixup>                     m_fixups        { };
+      int                                    m_depth         { 0 };
+    };
+  }
+
+  bool JitFunction::supported() {
+#if defined(__x86_64__) && !defined(_WIN32)
+    return true;
+#else
+    return false;
+#endif
+  }
+
+  JitFunction::JitFunction(const Expression& expr) {
+    if (!supported() || expr.root < 0)
+      return;
+
+    Emitter emitter { expr };
+
+    if (!emitter.run())
+      return;
+
+    const std::vector<std::uint8_t>& code { emitter.bytes() };
+    void* map { mmap(nullptr, code.size(), PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0) };
+
+    if (map == MAP_FAILED)
+      return;
+
+    std::memcpy(map, code.data(), code.size());
+
+    // Never writable and executable at the same time
+    if (mprotect(map, code.size(), PROT_READ | PROT_EXEC) != 0) {
+      munmap(map, code.size());
+      return;
+    }
+
+    m_map   = map;
+    m_bytes = code.size();
+    m_entry = reinterpret_cast<Entry>(map);
+  }
+
+  JitFunction::~JitFunction() {
+    if (m_map)
+      munmap(m_map, m_bytes);
+  }
+
+  CompiledExpression::CompiledExpression(const Expression& expr)
+    : m_bytecode { expr }, m_jit { expr } { }
+}
@@ -0,0 +1,72 @@
+// +--------------------------------------------+
+// |          x86-64 JIT FOR EXPRESSIONS        |
+// +--------------------------------------------+
+//
+// Translates an Expression straight into SSE2 machine code in an mmap'd
+// buffer, then calls it as double(const double* variables).
+//
+// Operands live on a stack of xmm registers (depth d uses xmm0..xmm(d-1)).
+// Constants sit in a RIP-relative pool after the code, fmod/pow are plain
+// calls with the live registers spilled, and the buffer is made read+exec
+// only after it is written. Expressions deeper than 16 registers, or
+// systems that forbid executable mappings, fall back to the bytecode tier.
+
+#pragma once
+
+#include "bytecode.h"
+#include "expression.h"
+
+#include <cstddef>
+#include <optional>
+#include <span>
+
+namespace Calc {
+  class JitFunction {
+  public:
+    using Entry = double (*)(const double* variables);
+
+    // True when this build targets x86-64 System V
+    static bool supported();
+
+    // Check valid(): compilation can fail (see above)
+    explicit JitFunction(const Expression& expr);
+    ~JitFunction();
+
+    JitFunction(const JitFunction&) = delete;
+    JitFunction& operator=(const JitFunction&) = delete;
+
+    bool valid() const { return m_entry != nullptr; }
+    std::size_t codeBytes() const { return m_bytes; }
+
+    double operator()(const double* variables) const { return m_entry(variables); }
+
+  private:
+    Entry       m_entry { nullptr };
+    void*       m_map   { nullptr };
+    std::size_t m_bytes { 0 };
+  };
+
+  // Highest tier that works for this expression: JIT, otherwise bytecode
+  class CompiledExpression {
+  public:
+    // Check valid(): when neither tier compiles, error() says why
+    explicit CompiledExpression(const Expression& expr);
+
+    bool valid() const              { return m_jit.valid() || m_bytecode.valid(); }
+    const ParseError& error() const { return m_bytecode.error(); }
+
+    // NaN when not valid() or variables.size() is not expr.variables.size()
+    double run(std::span<const double> variables) const {
+      if (!m_jit.valid() || variables.size() != m_bytecode.variableCount())
+        return m_bytecode.run(variables);
+
+      return m_jit(variables.data());
+    }
+
+    const char* tier() const { return m_jit.valid() ? "jit" : "bytecode"; }
+
+  private:
+    Bytecode    m_bytecode;
+    JitFunction m_jit;
+  };
+}
@@ -0,0 +1,170 @@
+#include "rational.h"
+
+#include <algorithm>
+#include <charconv>
+#include <limits>
+
+namespace Calc {
+  namespace {
+    using i128 = __int128;
+    using u128 = unsigned __int128;
+
+    constexpr i128 int64Max { std::numeric_limits<std::int64_t>::max() };
+
+    int ctz128(u128 x) {
+      const auto low { static_cast<std::uint64_t>(x) };
+      return low ? __builtin_ctzll(low) : 64 + __builtin_ctzll(static_cast<std::uint64_t>(x >> 64));
+    }
+
+    u128 binaryGcd128(u128 a, u128 b) {
+      if (a == 0)
+        return b;
+      if (b == 0)
+        return a;
+
+      const int shift { std::min(ctz128(a), ctz128(b)) };
+      a >>= ctz128(a);
+
+      while (b) {
+        b >>= ctz128(b);
+
+        if (a > b)
+          std::swap(a, b);
+
+        b -= a;
+      }
+
+      return a << shift;
+    }
+
+    // Stores n/d (d > 0), reducing when either part reaches 2^lazy; false if
+    // it cannot fit in 64 bits
+    bool settle(i128 n, i128 d, Rational& out, int lazy = lazyBits) {
+      const u128 magnitude { static_cast<u128>(n < 0 ? -n : n) };
+      const u128 limit     { lazy > 0 ? u128 { 1 } << lazy : 0 };
+
+      if (magnitude >= limit || static_cast<u128>(d) >= limit) {
+        const bool narrow { (magnitude | static_cast<u128>(d)) >> 64 == 0 };
+        const u128 g { narrow ? binaryGcd(static_cast<std::uint64_t>(magnitude), static_cast<std::uint64_t>(d))
+                              : binaryGcd128(magnitude, static_cast<u128>(d)) };
+
+        // gcd(0, d) = d, so zero becomes 0/1
+        n /= static_cast<i128>(g);
+        d /= static_cast<i128>(g);
+      }
+
+      if (n > int64Max || n < -int64Max || d > int64Max)
+        return false;
+
+      out = Rational { static_cast<std::int64_t>(n), static_cast<std::int64_t>(d) };
+      return true;
+    }
+  }
+
+  std::uint64_t binaryGcd(std::uint64_t a, std::uint64_t b) {
+    if (a == 0)
+      return b;
+    if (b == 0)
+      return a;
+
+    const int shift { __builtin_ctzll(a | b) };
+    b >>= __builtin_ctzll(b);
+
+    // b stays odd; a is the (shifted) difference, so the loop has no
+    // data-dependent swap branch. The difference is taken unsigned: as a
+    // signed value it overflows once an operand reaches 2^63.
+    while (a) {
+      a >>= __builtin_ctzll(a);
+
+      const std::uint64_t low  { std::min(a, b) };
+      const std::uint64_t high { std::max(a, b) };
+      b = low;
+      a = high - low;
+    }
+
+    return b << shift;
+  }
+
+  Rational reduced(Rational x) {
+    const std::uint64_t magnitude { x.num < 0 ? 0 - static_cast<std::uint64_t>(x.num) : static_cast<std::uint64_t>(x.num) };
+    const auto g { static_cast<std::int64_t>(binaryGcd(magnitude, static_cast<std::uint64_t>(x.den))) };
+
+    return Rational { x.num / g, x.den / g };
+  }
+
+  void reduceAll(std::span<Rational> values) {
+    for (Rational& x : values)
+      x = reduced(x);
+  }
+
+  bool makeRational(std::int64_t num, std::int64_t den, Rational& out) {
+    if (den == 0)
+      return false;
+
+    return settle(den < 0 ? -static_cast<i128>(num) : num, den < 0 ? -static_cast<i128>(den) : den, out);
+  }
+
+  bool parseRational(std::string_view text, Rational& out) {
+    const char* end { text.data() + text.size() };
+    std::int64_t num { }, den { 1 };
+
+    auto [p, ec] { std::from_chars(text.data(), end, num) };
+
+    if (ec != std::errc { })
+      return false;
+
+    if (p < end && *p == '/') {
+      auto [q, ecDen] { std::from_chars(p + 1, end, den) };
+
+      if (ecDen != std::errc { })
+        return false;
+
+      p = q;
+    }
+
+    return p == end && makeRational(num, den, out);
+  }
+
+  bool add(Rational a, Rational b, Rational& out, int lazy) {
+    if (a.den == b.den)
+      return settle(static_cast<i128>(a.num) + b.num, a.den, out, lazy);
+
+    return settle(static_cast<i128>(a.num) * b.den + static_cast<i128>(b.num) * a.den,
+                  static_cast<i128>(a.den) * b.den, out, lazy);
+  }
+
+  bool subtract(Rational a, Rational b, Rational& out, int lazy) {
+    return add(a, Rational { -b.num, b.den }, out, lazy);
+  }
+
+  bool multiply(Rational a, Rational b, Rational& out, int lazy) {
+    return settle(static_cast<i128>(a.num) * b.num, static_cast<i128>(a.den) * b.den, out, lazy);
+  }
+
+  bool divide(Rational a, Rational b, Rational& out, int lazy) {
+    if (b.num == 0)
+      return false;
+
+    // Keep the denominator positive
+    const i128 sign { b.num < 0 ? -1 : 1 };
+    return settle(sign * a.num * b.den, sign * a.den * b.num, out, lazy);
+  }
+
+  bool operator==(Rational a, Rational b) {
+    return static_cast<i128>(a.num) * b.den == static_cast<i128>(b.num) * a.den;
+  }
+
+  double toDouble(Rational x) {
+    const Rational r { reduced(x) };
+    return static_cast<double>(r.num) / static_cast<double>(r.den);
+  }
+
+  std::string toString(Rational x) {
+    const Rational r { reduced(x) };
+
+    if (r.den == 1)
+      return std::to_string(r.num);
+
+    return std::to_string(r.num) + '/' + std::to_string(r.den);
+  }
+}
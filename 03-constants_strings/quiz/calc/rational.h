@@ -0,0 +1,57 @@
+// +--------------------------------------------+
+// |            EXACT RATIONAL ARITHMETIC       |
+// +--------------------------------------------+
+//
+// Fractions num/den on 64-bit integers with den > 0. Intermediate results
+// are computed in 128 bits, so the only failure is a final value that does
+// not fit; the operations then return false.
+//
+// Reduction is lazy: a result is left unreduced while both parts stay below
+// 2^lazyBits, and only larger results pay for a gcd. The gcd is Stein's
+// binary algorithm (shifts by count-trailing-zeros and subtraction, no
+// division).
+
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+
+namespace Calc {
+  // Results smaller than this (in bits) skip reduction; 0 reduces every time.
+  // The arithmetic below takes another value as its last argument (for tuning)
+  inline constexpr int lazyBits { 32 };
+
+  struct Rational {
+    std::int64_t num { 0 };
+    std::int64_t den { 1 }; // always positive, not necessarily in lowest terms
+  };
+
+  std::uint64_t binaryGcd(std::uint64_t a, std::uint64_t b);
+
+  // Lowest terms
+  Rational reduced(Rational x);
+
+  // Brings every fraction to lowest terms
+  void reduceAll(std::span<Rational> values);
+
+  // false when den is 0
+  bool makeRational(std::int64_t num, std::int64_t den, Rational& out);
+
+  // "3/4", "-5" or "2/-6"; false on anything else
+  bool parseRational(std::string_view text, Rational& out);
+
+  // false on overflow (and for divide, on a zero divisor)
+  bool add(Rational a, Rational b, Rational& out, int lazy = lazyBits);
+  bool subtract(Rational a, Rational b, Rational& out, int lazy = lazyBits);
+  bool multiply(Rational a, Rational b, Rational& out, int lazy = lazyBits);
+  bool divide(Rational a, Rational b, Rational& out, int lazy = lazyBits);
+
+  bool operator==(Rational a, Rational b);
+
+  double toDouble(Rational x);
+
+  // Lowest terms, "num/den" or just "num" for integers
+  std::string toString(Rational x);
+}
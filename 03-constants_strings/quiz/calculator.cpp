@@ -1,64 +1,290 @@
-#include <iostream>
+// g++ -std=c++20 -O2 calculator.cpp calc/expression.cpp calc/bytecode.cpp calc/jit.cpp calc/columns.cpp calc/bigint.cpp calc/rational.cpp ../../common/checked.cpp ../../common/int_parse.cpp -o calculator
+// (add -DUSE_FAST_IO ../../common/fast_io.cpp ../../common/int_format.cpp ../../common/float_parse.cpp for buffered I/O)
 
-int add(int a, int b) {
-  return a + b; 
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "calc/bigint.h"
+#include "calc/bytecode.h"
+#include "calc/columns.h"
+#include "calc/expression.h"
+#include "calc/jit.h"
+#include "calc/rational.h"
+#include "../../common/checked.h"
+#include "../../common/console.h"
+
+// std::nullopt when the result does not fit in an int
+std::optional<int> add(int a, int b) {
+  return Checked::add<Checked::Report>(a, b);
+}
+
+std::optional<int> subtract(int a, int b) {
+  return Checked::subtract<Checked::Report>(a, b);
 }
 
-int subtract(int a, int b) { 
-  return a - b; 
+double divide(double a, double b) {
+  return a / b;
 }
 
-int divide(double a, double b) { 
-  return a / b; 
+std::optional<int> multiply(int a, int b) {
+  return Checked::multiply<Checked::Report>(a, b);
 }
 
-int multiply(int a, int b) { 
-  return a * b; 
+void print(std::optional<int> result) {
+  if (result)
+    Console::out << *result;
+  else
+    Console::out << "too big for an int lil bro, use [7]\n";
 }
 
 void ask(int &x, int &y) {
-  std::cout << "Enter 2 numbers\n";
-  std::cin  >> x >> y;
+  Console::out << "Enter 2 numbers\n";
+  Console::in  >> x >> y;
+}
+
+// Parses a whole expression, asks for each variable, runs it as a
+// Calc::CompiledExpression (JIT, with bytecode as the fallback)
+void evaluateExpression() {
+  std::string source { };
+
+  Console::out << "Enter an expression (e.g. (x + 3) * y ^ 2): ";
+  Console::readLine(source);
+
+  Calc::Expression expr  { };
+  Calc::ParseError error { };
+
+  if (!Calc::parse(source, expr, error)) {
+    Console::out << "error at column " << error.position + 1 << ": " << error.message << '\n';
+    return;
+  }
+
+  const Calc::CompiledExpression compiled { expr };
+
+  if (!compiled.valid()) {
+    Console::out << "error: " << compiled.error().message << '\n';
+    return;
+  }
+
+  std::vector<double> values(expr.variables.size());
+
+  for (std::size_t i { 0 }; i < values.size(); ++i) {
+    Console::out << expr.variables[i] << " = ";
+    Console::in  >> values[i];
+  }
+
+  Console::out << compiled.run(values) << '\n';
+}
+
+// Applies one operation to every "a b" line of a file
+void runBatchFile() {
+  int operation { };
+  std::string input { }, output { };
+
+  Console::out << "Operation [1-4]: ";
+  Console::in  >> operation;
+
+  if (operation < 1 || operation > 4) {
+    Console::out << "shut your bitch ass up lil bro\n";
+    return;
+  }
+
+  Console::out << "Input file (two columns): ";
+  Console::in  >> input;
+  Console::out << "Output file: ";
+  Console::in  >> output;
+
+  Calc::Columns columns { };
+  std::string error { };
+
+  if (!Calc::readColumns(input, columns, error)) {
+    Console::out << error << '\n';
+    return;
+  }
+
+  const auto op { static_cast<Calc::Operation>(operation) };
+  const Calc::BatchResult result { Calc::runBatch(op, columns) };
+
+  // Rows are numbered from 1, counting only non-blank lines. A wrapped
+  // result is never written out
+  if (result.overflow) {
+    Console::out << "too big for an int on row " << *result.overflow + 1 << " lil bro, use [7]\n";
+    return;
+  }
+
+  if (!Calc::writeResult(output, op, result)) {
+    Console::out << "could not write " << output << '\n';
+    return;
+  }
+
+  Console::out << columns.a.size() << " rows (" << Calc::isaName(Calc::detectIsa()) << ")\n";
+
+  if (!result.divideByZero.empty()) {
+    Console::out << "u stupid lil bro? division by zero on " << result.divideByZero.size() << " rows:";
+
+    for (std::size_t i { 0 }; i < result.divideByZero.size() && i < 20; ++i)
+      Console::out << ' ' << result.divideByZero[i] + 1;
+
+    Console::out << (result.divideByZero.size() > 20 ? " ...\n" : "\n");
+  }
+}
+
+// Exact arithmetic on integers of any length
+void runBigIntegers() {
+  std::string left { }, right { };
+  char op { };
+
+  Console::out << "Enter a: ";
+  Console::in  >> left;
+  Console::out << "Operator (+ - * / %): ";
+  Console::in  >> op;
+  Console::out << "Enter b: ";
+  Console::in  >> right;
+
+  Calc::BigInt a { }, b { };
+
+  if (!Calc::BigInt::fromString(left, a) || !Calc::BigInt::fromString(right, b)) {
+    Console::out << "that ain't an integer lil bro\n";
+    return;
+  }
+
+  Calc::BigInt quotient { }, remainder { };
+
+  switch (op) {
+    case '+': Console::out << (a + b).toString() << '\n'; break;
+    case '-': Console::out << (a - b).toString() << '\n'; break;
+    case '*': Console::out << (a * b).toString() << '\n'; break;
+
+    case '/':
+    case '%':
+      if (!Calc::BigInt::divmod(a, b, quotient, remainder)) {
+        Console::out << "u stupid lil bro?\n";
+        break;
+      }
+
+      Console::out << (op == '/' ? quotient : remainder).toString() << '\n';
+      break;
+
+    default:
+      Console::out << "shut your bitch ass up lil bro\n";
+      break;
+  }
+}
+
+// Left-to-right chain of fractions, e.g. "1/3 + 1/6 * 3/4 =", kept exact
+void runRationalChain() {
+  std::string token { };
+  Calc::Rational total { }, next { };
+
+  Console::out << "Enter fractions and operators, ending with = (e.g. 1/3 + 1/6 * 3/4 =): ";
+  Console::in  >> token;
+
+  if (!Calc::parseRational(token, total)) {
+    Console::out << "that ain't a fraction lil bro\n";
+    return;
+  }
+
+  for (char op { }; Console::in >> op && op != '='; ) {
+    Console::in >> token;
+
+    if (!Calc::parseRational(token, next)) {
+      Console::out << "that ain't a fraction lil bro\n";
+      return;
+    }
+
+    bool ok { false };
+
+    switch (op) {
+      case '+': ok = Calc::add(total, next, total);      break;
+      case '-': ok = Calc::subtract(total, next, total); break;
+      case '*': ok = Calc::multiply(total, next, total); break;
+
+      case '/':
+        if (next.num == 0) {
+          Console::out << "u stupid lil bro?\n";
+          return;
+        }
+
+        ok = Calc::divide(total, next, total);
+        break;
+
+      default:
+        Console::out << "shut your bitch ass up lil bro\n";
+        return;
+    }
+
+    if (!ok) {
+      Console::out << "too big for 64 bits lil bro\n";
+      return;
+    }
+  }
+
+  Console::out << Calc::toString(total) << " = " << Calc::toDouble(total) << '\n';
 }
 
 int main() {
 
   int x { }, y { }, choice{ };
 
-  std::cout << R"(Choose operation 
+  Console::out << R"(Choose operation 
                 [1] Addition
                 [2] Subtraction
                 [3] Divison
-                [4] Multiplication: )";
+                [4] Multiplication
+                [5] Expression
+                [6] Batch (file)
+                [7] Big integers
+                [8] Fractions: )";
   
-  std::cin >> choice;
+  Console::in >> choice;
+
+  if (choice == 5) {
+    evaluateExpression();
+    return 0;
+  }
+
+  if (choice == 6) {
+    runBatchFile();
+    return 0;
+  }
+
+  if (choice == 7) {
+    runBigIntegers();
+    return 0;
+  }
+
+  if (choice == 8) {
+    runRationalChain();
+    return 0;
+  }
 
   ask(x, y);
 
   switch (choice)
   {
     case 1:
-      std::cout << add(x, y);
+      print(add(x, y));
       break;
 
     case 2:
-      std::cout << subtract(x, y);
+      print(subtract(x, y));
       break;
 
     case 3:
       if (y == 0) {
-        std::cout << "u stupid lil bro?\n";
+        Console::out << "u stupid lil bro?\n";
         break;
       }
 
-      std::cout << divide(x, y);
+      Console::out << divide(x, y);
+      break;
 
     case 4:
-      std::cout << multiply(x, y);
+      print(multiply(x, y));
       break;
 
     default:
-      std::cout << "shut your bitch ass up lil bro\n";
+      Console::out << "shut your bitch ass up lil bro\n";
       break;
   } 
   
@@ -1,31 +1,43 @@
-#include <iostream>
+// g++ -std=c++20 -O2 -pthread prime_number.cpp primes/miller_rabin.cpp primes/prime_cache.cpp primes/sieve.cpp -o prime_number
+// ./prime_number              any number up to 2^64 - 1, answered by Miller-Rabin
+// ./prime_number primes.bmp   numbers below 2^32 looked up in (and added to) a prime cache file
 
-int main() {
-  int  number  { };
-  bool isPrime { true };
+#include "primes/miller_rabin.h"
+#include "primes/prime_cache.h"
+#include "../../common/console.h"
 
-  std::cout << "Input a digit: ";
-  std::cin  >> number;
+#include <charconv>
+#include <cstdint>
+#include <optional>
+#include <string>
 
-  if (number < 2) {
-    isPrime = false;
-  }
+int main(int argc, char** argv) {
+  std::optional<Primes::PrimeCache> cache { };
+
+  if (argc > 1)
+    cache.emplace(argv[1]);
+
+  std::string   digits { };
+  std::uint64_t number { };
+
+  Console::out << "Input a digit: ";
+  Console::in  >> digits;
+
+  // Negative numbers and anything else that is not a whole number are not prime
+  const auto [end, ec] { std::from_chars(digits.data(), digits.data() + digits.size(), number) };
+  const bool isNumber { ec == std::errc { } && end == digits.data() + digits.size() };
+
+  // Numbers past the cache's cap fall through to Miller-Rabin inside isPrime()
+  const bool isPrime {
+    isNumber && (cache && cache->isOpen() ? cache->isPrime(number) : Primes::isPrime64(number))
+  };
 
-  else {
-    for (int divisor = 2; number <= divisor / divisor; ++divisor) {
-      if (number % divisor == 0) {
-        isPrime = false;
-        break;
-      }
-    }
-  }
-  
   if (!isPrime) {
-    std::cout << "Not a prime digit\n";
+    Console::out << "Not a prime digit\n";
   }
 
   else {
-    std::cout << "Prime digit detected\n";
+    Console::out << "Prime digit detected\n";
   }
 
 }
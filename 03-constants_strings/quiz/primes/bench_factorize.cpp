@@ -0,0 +1,86 @@
+// +--------------------------------------------+
+// |           FACTORIZATION THROUGHPUT         |
+// +--------------------------------------------+
+//
+// g++ -std=c++20 -O2 -march=native -pthread miller_rabin.cpp factorize.cpp bench_factorize.cpp -o bench_factor
+// ./bench_factor [count] [threads]   (defaults: 1'000'000 values, every hardware thread)
+
+#include "factorize.h"
+#include "miller_rabin.h"
+
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <vector>
+
+namespace {
+  double secondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  }
+
+  // Every factor list must be prime and multiply back to its value
+  bool verify(const std::vector<std::uint64_t>& values, const Primes::FactorBatch& batch) {
+    for (std::size_t i { 0 }; i < values.size(); ++i) {
+      std::uint64_t product { 1 };
+
+      for (std::size_t j { batch.offsets[i] }; j < batch.offsets[i + 1]; ++j) {
+        if (!Primes::isPrime64(batch.factors[j]))
+          return false;
+
+        product *= batch.factors[j];
+      }
+
+      if (values[i] > 1 && product != values[i])
+        return false;
+    }
+
+    return true;
+  }
+
+  void bench(const std::vector<std::uint64_t>& values, unsigned threads, const char* label) {
+    auto start { std::chrono::steady_clock::now() };
+    Primes::FactorBatch batch { Primes::factorizeBatch(values, threads) };
+    double seconds { secondsSince(start) };
+
+    std::cout << label << ": " << values.size() / seconds << " factorizations/s"
+              << (verify(values, batch) ? "" : "  [WRONG RESULT]") << '\n';
+  }
+}
+
+int main(int argc, char** argv) {
+  std::size_t count   { argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1'000'000ull };
+  unsigned    threads { argc > 2 ? static_cast<unsigned>(std::strtoul(argv[2], nullptr, 10)) : 0u };
+
+  std::mt19937_64 rng { 11 };
+
+  std::vector<std::uint64_t> uniform(count);
+  for (std::uint64_t& v : uniform)
+    v = rng();
+
+  // Two ~32-bit primes: nothing for trial division, all work in Pollard-Rho
+  std::vector<std::uint64_t> semiprimes(count / 10);
+  auto randomPrime = [&] {
+    std::uint64_t p { (rng() >> 32) | (1ull << 31) | 1 };
+    while (!Primes::isPrime64(p))
+      p += 2;
+    return p;
+  };
+  for (std::uint64_t& v : semiprimes)
+    v = randomPrime() * randomPrime();
+
+  // Above 2^63, where x^2 + c can carry out of 64 bits
+  std::vector<std::uint64_t> large(count / 10);
+  for (std::uint64_t& v : large) {
+    do
+      v = randomPrime() * randomPrime();
+    while (v >> 63 == 0);
+  }
+
+  bench(uniform,    threads, "random 64-bit  ");
+  bench(semiprimes, threads, "32x32 semiprime");
+  bench(large,      threads, "semiprime >2^63");
+
+  return 0;
+}
@@ -0,0 +1,99 @@
+// +--------------------------------------------+
+// |        MILLER-RABIN VS TRIAL DIVISION      |
+// +--------------------------------------------+
+//
+// g++ -std=c++20 -O2 -march=native -pthread miller_rabin.cpp bench_miller_rabin.cpp -o bench_mr
+// ./bench_mr [count]   (default: 1'000'000 random inputs)
+
+#include "miller_rabin.h"
+
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <vector>
+
+namespace {
+  // The loop from prime_number.cpp, widened to 64 bits
+  bool trialDivision(std::uint64_t number) {
+    if (number < 2)
+      return false;
+
+    for (std::uint64_t divisor = 2; divisor <= number / divisor; ++divisor) {
+      if (number % divisor == 0)
+        return false;
+    }
+
+    return true;
+  }
+
+  double secondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  }
+
+  std::vector<std::uint64_t> randomValues(std::size_t count, std::uint64_t mask) {
+    std::mt19937_64 rng { 42 };
+    std::vector<std::uint64_t> values(count);
+
+    for (std::uint64_t& v : values)
+      v = rng() & mask;
+
+    return values;
+  }
+
+  std::size_t countBits(const std::vector<std::uint64_t>& bitmap) {
+    std::size_t count { 0 };
+
+    for (std::uint64_t word : bitmap)
+      count += static_cast<std::size_t>(__builtin_popcountll(word));
+
+    return count;
+  }
+
+  void benchBatch(const std::vector<std::uint64_t>& values, unsigned threads, const char* label) {
+    auto start { std::chrono::steady_clock::now() };
+    std::vector<std::uint64_t> bitmap { Primes::isPrimeBatch(values, threads) };
+    double seconds { secondsSince(start) };
+
+    std::cout << label << ": " << countBits(bitmap) << " primes, "
+              << seconds * 1e9 / values.size() << " ns/value\n";
+  }
+}
+
+int main(int argc, char** argv) {
+  std::size_t count { argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1'000'000ull };
+
+  // Full 64-bit inputs: trial division would need ~2^32 steps per prime
+  std::vector<std::uint64_t> wide { randomValues(count, ~0ull) };
+  benchBatch(wide, 1, "batch MR, 64-bit, 1 thread  ");
+  benchBatch(wide, 0, "batch MR, 64-bit, all threads");
+
+  auto start { std::chrono::steady_clock::now() };
+  std::size_t primes { 0 };
+  for (std::uint64_t v : wide)
+    primes += Primes::isPrime64(v);
+  std::cout << "isPrime64 one at a time      : " << primes << " primes, "
+            << secondsSince(start) * 1e9 / count << " ns/value\n";
+
+  // 40-bit inputs keep the trial loop finishable (sqrt <= 2^20)
+  std::vector<std::uint64_t> narrow { randomValues(20'000, (1ull << 40) - 1) };
+
+  start = std::chrono::steady_clock::now();
+  std::size_t trialPrimes { 0 };
+  for (std::uint64_t v : narrow)
+    trialPrimes += trialDivision(v);
+  double trialSeconds { secondsSince(start) };
+
+  start = std::chrono::steady_clock::now();
+  std::vector<std::uint64_t> bitmap { Primes::isPrimeBatch(narrow, 1) };
+  double batchSeconds { secondsSince(start) };
+
+  std::cout << "40-bit, trial loop           : " << trialPrimes << " primes, "
+            << trialSeconds * 1e9 / narrow.size() << " ns/value\n";
+  std::cout << "40-bit, batch MR             : " << countBits(bitmap) << " primes, "
+            << batchSeconds * 1e9 / narrow.size() << " ns/value ("
+            << trialSeconds / batchSeconds << "x faster)\n";
+
+  return 0;
+}
@@ -0,0 +1,62 @@
+// +--------------------------------------------+
+// |          PRIME CACHE LATENCY BENCH         |
+// +--------------------------------------------+
+//
+// g++ -std=c++20 -O2 -march=native -pthread sieve.cpp miller_rabin.cpp prime_cache.cpp bench_prime_cache.cpp -o bench_cache
+// ./bench_cache [file] [limit]   (defaults: primes.bmp, 1e9)
+//
+// Run it twice: the first run builds the file, the second only maps it.
+
+#include "prime_cache.h"
+
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+
+namespace {
+  double microsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+  }
+}
+
+int main(int argc, char** argv) {
+  std::string   path  { argc > 1 ? argv[1] : "primes.bmp" };
+  std::uint64_t limit { argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 1'000'000'000ull };
+
+  auto start { std::chrono::steady_clock::now() };
+  Primes::PrimeCache cache { path };
+
+  if (!cache.isOpen()) {
+    std::cout << "could not open " << path << '\n';
+    return 1;
+  }
+
+  std::cout << "open:         " << microsSince(start) << " us (cached limit " << cache.limit() << ")\n";
+
+  start = std::chrono::steady_clock::now();
+  bool prime { cache.isPrime(limit - 1) };
+  std::cout << "first query:  " << microsSince(start) << " us (" << limit - 1
+            << (prime ? " is prime)\n" : " is not prime)\n");
+
+  std::mt19937_64 rng { 7 };
+  constexpr int queries { 10'000'000 };
+  std::size_t primes { 0 };
+
+  start = std::chrono::steady_clock::now();
+  for (int i { 0 }; i < queries; ++i)
+    primes += cache.isPrime(rng() % limit);
+
+  std::cout << "random query: " << microsSince(start) * 1000 / queries << " ns ("
+            << primes << " primes in " << queries << " queries)\n";
+
+  // Past maxLimit the answer comes from Miller-Rabin and the file stays put
+  const std::uint64_t before { cache.limit() };
+  prime = cache.isPrime((1ull << 61) - 1);
+  std::cout << "2^61 - 1:     " << (prime ? "prime" : "not prime") << ", cached limit " << cache.limit()
+            << (prime && cache.limit() == before ? "\n" : "  [WRONG]\n");
+
+  return 0;
+}
@@ -0,0 +1,41 @@
+// +--------------------------------------------+
+// |          pi(x) / NTH PRIME TIMINGS         |
+// +--------------------------------------------+
+//
+// g++ -std=c++20 -O2 -march=native -pthread sieve.cpp miller_rabin.cpp prime_count.cpp bench_prime_count.cpp -o bench_pi
+// ./bench_pi [threads]   (default: every hardware thread)
+
+#include "prime_count.h"
+
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+
+namespace {
+  double secondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  }
+}
+
+int main(int argc, char** argv) {
+  unsigned threads { argc > 1 ? static_cast<unsigned>(std::strtoul(argv[1], nullptr, 10)) : 0u };
+
+  // Reference values: pi(1e9) = 50847534, pi(1e11) = 4118054813, pi(1e13) = 346065536839
+  for (std::uint64_t x : { 1'000'000'000ull, 100'000'000'000ull, 10'000'000'000'000ull }) {
+    auto start { std::chrono::steady_clock::now() };
+    std::uint64_t count { Primes::primePi(x, threads) };
+
+    std::cout << "pi(" << x << ") = " << count << " in " << secondsSince(start) << " s\n";
+  }
+
+  // Reference values: p(1e9) = 22801763489, p(1e10) = 252097800623, p(1e11) = 2760727302517
+  for (std::uint64_t n : { 1'000'000'000ull, 10'000'000'000ull, 100'000'000'000ull }) {
+    auto start { std::chrono::steady_clock::now() };
+    std::uint64_t prime { Primes::nthPrime(n, threads) };
+
+    std::cout << "nthPrime(" << n << ") = " << prime << " in " << secondsSince(start) << " s\n";
+  }
+
+  return 0;
+}
@@ -0,0 +1,54 @@
+// +--------------------------------------------+
+// |            SIEVE THROUGHPUT BENCH          |
+// +--------------------------------------------+
+//
+// g++ -std=c++20 -O2 -march=native -pthread sieve.cpp miller_rabin.cpp bench_sieve.cpp -o bench_sieve
+// ./bench_sieve [width]   (default width: 1e9 numbers per range)
+
+#include "sieve.h"
+
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+
+namespace {
+  double secondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  }
+
+  void benchRange(const Primes::SegmentedSieve& sieve, std::uint64_t lo, std::uint64_t hi) {
+    auto start { std::chrono::steady_clock::now() };
+    std::uint64_t count { sieve.countPrimes(lo, hi) };
+    double seconds { secondsSince(start) };
+
+    std::cout << "count  [" << lo << ", " << hi << "): " << count << " primes in "
+              << seconds << " s -> " << count / seconds / 1e6 << " M primes/s\n";
+
+    // Enumerating every prime adds the bit-extraction cost on top of sieving
+    start = std::chrono::steady_clock::now();
+    std::uint64_t checksum { 0 };
+    sieve.forEachPrime(lo, hi, [&](std::uint64_t p) { checksum += p; });
+    seconds = secondsSince(start);
+
+    std::cout << "visit  [" << lo << ", " << hi << "): checksum " << checksum << " in "
+              << seconds << " s -> " << count / seconds / 1e6 << " M primes/s\n";
+  }
+}
+
+int main(int argc, char** argv) {
+  std::uint64_t width { argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1'000'000'000ull };
+
+  const std::uint64_t top { 1'000'000'000'000ull };
+  Primes::SegmentedSieve sieve { top + width + 1 };
+
+  benchRange(sieve, 0, width);
+  benchRange(sieve, top, top + width);
+
+  auto start { std::chrono::steady_clock::now() };
+  bool prime { sieve.isPrime(999'999'999'989ull) };
+  std::cout << "isPrime(999999999989): " << std::boolalpha << prime
+            << " in " << secondsSince(start) * 1e6 << " us\n";
+
+  return 0;
+}
@@ -0,0 +1,222 @@
+#include "factorize.h"
+#include "miller_rabin.h"
+#include "montgomery.h"
+
+#include <algorithm>
+#include <limits>
+#include <thread>
+
+namespace Primes {
+  namespace {
+    constexpr std::uint64_t trialBound { 1024 };
+
+    // For odd p, n is a multiple of p exactly when n * p^-1 (mod 2^64) <= max / p,
+    // and the product is then the quotient. No division instruction is needed.
+    struct TrialPrime {
+      std::uint64_t prime   { };
+      std::uint64_t inverse { };
+      std::uint64_t limit   { };
+    };
+
+    constexpr auto trialTable {
+      [] {
+        struct Table {
+          TrialPrime  entries[200] { };
+          std::size_t size         { 0 };
+        } table { };
+
+        bool composite[trialBound] { };
+
+        for (std::uint64_t i { 3 }; i < trialBound; i += 2) {
+          if (composite[i])
+            continue;
+
+          for (std::uint64_t j { i * i }; j < trialBound; j += 2 * i)
+            composite[j] = true;
+
+          std::uint64_t inverse { i };
+          for (int k { 0 }; k < 5; ++k)
+            inverse *= 2 - i * inverse;
+
+          table.entries[table.size++] = TrialPrime { i, inverse, std::numeric_limits<std::uint64_t>::max() / i };
+        }
+
+        return table;
+      }()
+    };
+
+    // Stein's binary gcd
+    std::uint64_t gcd(std::uint64_t a, std::uint64_t b) {
+      if (a == 0 || b == 0)
+        return a | b;
+
+      const int shift { __builtin_ctzll(a | b) };
+      a >>= __builtin_ctzll(a);
+
+      while (b != 0) {
+        b >>= __builtin_ctzll(b);
+
+        if (a > b)
+          std::swap(a, b);
+
+        b -= a;
+      }
+
+      return a << shift;
+    }
+
+    // A nontrivial divisor of the odd composite n
+    std::uint64_t pollardBrent(std::uint64_t n) {
+      constexpr std::uint64_t batch { 128 };
+
+      const Montgomery mont { n };
+
+      for (std::uint64_t c { 1 }; ; ++c) {
+        const std::uint64_t add { mont.toMont(c) };
+
+        auto f = [&](std::uint64_t v) { return mont.add(mont.mul(v, v), add); };
+
+        std::uint64_t y { mont.toMont(2) }, x { y }, ys { y };
+        std::uint64_t q { mont.one };
+        std::uint64_t g { 1 };
+
+        for (std::uint64_t r { 1 }; g == 1; r *= 2) {
+          x = y;
+
+          for (std::uint64_t i { 0 }; i < r; ++i)
+            y = f(y);
+
+          for (std::uint64_t k { 0 }; k < r && g == 1; k += batch) {
+            ys = y;
+
+            for (std::uint64_t i { 0 }; i < std::min(batch, r - k); ++i) {
+              y = f(y);
+              q = mont.mul(q, x > y ? x - y : y - x);
+            }
+
+            g = gcd(q, n);
+          }
+        }
+
+        // The batch overshot: step again one difference at a time
+        if (g == n) {
+          do {
+            ys = f(ys);
+            g  = gcd(x > ys ? x - ys : ys - x, n);
+          } while (g == 1);
+        }
+
+        if (g != n)
+          return g;
+      }
+    }
+
+    // Appends the prime factors of n (unsorted)
+    void factorInto(std::uint64_t n, std::vector<std::uint64_t>& out) {
+      if (n < 2)
+        return;
+
+      const int twos { __builtin_ctzll(n) };
+      out.insert(out.end(), static_cast<std::size_t>(twos), 2);
+      n >>= twos;
+
+      for (std::size_t i { 0 }; i < trialTable.size && n > 1; ++i) {
+        const TrialPrime& tp { trialTable.entries[i] };
+
+        if (tp.prime * tp.prime > n)
+          break;
+
+        for (std::uint64_t q { n * tp.inverse }; q <= tp.limit; q = n * tp.inverse) {
+          out.push_back(tp.prime);
+          n = q;
+        }
+      }
+
+      if (n == 1)
+        return;
+
+      // Nothing below 1024 divides n, so n < 1024^2 must be prime
+      if (n < trialBound * trialBound) {
+        out.push_back(n);
+        return;
+      }
+
+      std::uint64_t pending[64] { n };
+      int top { 1 };
+
+      while (top > 0) {
+        const std::uint64_t m { pending[--top] };
+
+        if (isPrime64(m)) {
+          out.push_back(m);
+          continue;
+        }
+
+        const std::uint64_t d { pollardBrent(m) };
+        pending[top++] = d;
+        pending[top++] = m / d;
+      }
+    }
+  }
+
+  std::vector<std::uint64_t> factorize(std::uint64_t n) {
+    std::vector<std::uint64_t> factors { };
+    factorInto(n, factors);
+    std::sort(factors.begin(), factors.end());
+
+    return factors;
+  }
+
+  FactorBatch factorizeBatch(std::span<const std::uint64_t> values, unsigned threads) {
+    if (threads == 0)
+      threads = std::max(1u, std::thread::hardware_concurrency());
+
+    threads = static_cast<unsigned>(std::min<std::size_t>(threads, std::max<std::size_t>(1, values.size())));
+
+    // Each thread fills its own arrays for a contiguous slice; they are
+    // concatenated afterwards so the output keeps input order
+    struct Slice {
+      std::vector<std::uint64_t> factors { };
+      std::vector<std::size_t>   counts  { };
+    };
+
+    std::vector<Slice>       slices(threads);
+    std::vector<std::thread> workers { };
+    const std::size_t        perThread { (values.size() + threads - 1) / threads };
+
+    for (unsigned t { 0 }; t < threads; ++t) {
+      workers.emplace_back([&, t] {
+        const std::size_t begin { std::min(values.size(), t * perThread) };
+        const std::size_t end   { std::min(values.size(), begin + perThread) };
+        Slice& slice { slices[t] };
+
+        slice.factors.reserve((end - begin) * 4);
+        slice.counts.reserve(end - begin);
+
+        for (std::size_t i { begin }; i < end; ++i) {
+          const std::size_t first { slice.factors.size() };
+
+          factorInto(values[i], slice.factors);
+          std::sort(slice.factors.begin() + static_cast<std::ptrdiff_t>(first), slice.factors.end());
+          slice.counts.push_back(slice.factors.size() - first);
+        }
+      });
+    }
+
+    for (std::thread& worker : workers)
+      worker.join();
+
+    FactorBatch batch { };
+    batch.offsets.reserve(values.size() + 1);
+    batch.offsets.push_back(0);
+
+    for (const Slice& slice : slices) {
+      batch.factors.insert(batch.factors.end(), slice.factors.begin(), slice.factors.end());
+
+      for (std::size_t count : slice.counts)
+        batch.offsets.push_back(batch.offsets.back() + count);
+    }
+
+    return batch;
+  }
+}
@@ -0,0 +1,31 @@
+// +--------------------------------------------+
+// |        INTEGER FACTORIZATION (64-BIT)      |
+// +--------------------------------------------+
+//
+// Full prime factorization of 64-bit values:
+//   1. trial division by the primes below 1024 (divisibility by multiply)
+//   2. Miller-Rabin on what is left, which is often already prime
+//   3. Pollard-Rho with Brent's cycle detection for the remaining composites;
+//      differences are multiplied together and gcd'ed once per 128 steps
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace Primes {
+  // Prime factors of n in ascending order, repeated by multiplicity (empty for 0 and 1)
+  std::vector<std::uint64_t> factorize(std::uint64_t n);
+
+  // Factors of every value in one flat array: values[i] owns
+  // factors[offsets[i], offsets[i + 1])
+  struct FactorBatch {
+    std::vector<std::uint64_t> factors { };
+    std::vector<std::size_t>   offsets { };
+  };
+
+  // threads = 0 uses every hardware thread
+  FactorBatch factorizeBatch(std::span<const std::uint64_t> values, unsigned threads = 0);
+}
@@ -0,0 +1,180 @@
+#include "miller_rabin.h"
+#include "montgomery.h"
+
+#include <algorithm>
+#include <thread>
+
+namespace Primes {
+  namespace {
+    constexpr std::uint64_t bases[] { 2, 325, 9375, 28178, 450775, 9780504, 1795265022 };
+
+    constexpr std::uint32_t screenPrimes[] {
+      3, 5, 7, 11, 13, 17, 19, 23, 29, 31, 37, 41, 43, 47, 53, 59, 61
+    };
+
+    // Candidates whose multiply chains run interleaved
+    constexpr int lanes { 4 };
+
+    enum class Verdict { composite, prime, unknown };
+
+    Verdict screen(std::uint64_t n) {
+      if (n < 2)
+        return Verdict::composite;
+
+      if (n % 2 == 0)
+        return n == 2 ? Verdict::prime : Verdict::composite;
+
+      for (std::uint32_t p : screenPrimes) {
+        if (n % p == 0)
+          return n == p ? Verdict::prime : Verdict::composite;
+      }
+
+      // No factor up to 61 and below 67^2 means no factor at all
+      return n < 67 * 67 ? Verdict::prime : Verdict::unknown;
+    }
+
+    // One Miller-Rabin round with `base` for `count` (<= lanes) candidates.
+    // The square-and-multiply ladders of all lanes advance together.
+    void strongProbe(const Montgomery* mont, int count, std::uint64_t base, bool* passed) {
+      std::uint64_t d[lanes] { }, a[lanes] { }, x[lanes] { };
+      int s[lanes] { };
+      int topBit { 0 };
+
+      for (int j { 0 }; j < count; ++j) {
+        const std::uint64_t n { mont[j].n };
+
+        s[j] = __builtin_ctzll(n - 1);
+        d[j] = (n - 1) >> s[j];
+        a[j] = mont[j].toMont(base);
+        x[j] = mont[j].one;
+        topBit = std::max(topBit, 64 - __builtin_clzll(d[j]));
+      }
+
+      for (int bit { topBit - 1 }; bit >= 0; --bit) {
+        for (int j { 0 }; j < count; ++j) {
+          const std::uint64_t factor { ((d[j] >> bit) & 1) ? a[j] : mont[j].one };
+          x[j] = mont[j].mul(mont[j].mul(x[j], x[j]), factor);
+        }
+      }
+
+      for (int j { 0 }; j < count; ++j) {
+        const Montgomery&   m        { mont[j] };
+        const std::uint64_t minusOne { m.n - m.one };
+
+        // base == 0 (mod n) says nothing about n
+        if (a[j] == 0 || x[j] == m.one || x[j] == minusOne) {
+          passed[j] = true;
+          continue;
+        }
+
+        passed[j] = false;
+
+        for (int r { 1 }; r < s[j]; ++r) {
+          x[j] = m.mul(x[j], x[j]);
+
+          if (x[j] == minusOne) {
+            passed[j] = true;
+            break;
+          }
+
+          if (x[j] == m.one)
+            break;
+        }
+      }
+    }
+
+    // Fills bitmap words for values[begin, end); begin is a multiple of 64
+    void testRange(std::span<const std::uint64_t> values, std::size_t begin, std::size_t end,
+                   std::uint64_t* bitmap) {
+      std::vector<std::size_t> pending { };
+      std::vector<Montgomery>  contexts { };
+
+      for (std::size_t i { begin }; i < end; ++i) {
+        switch (screen(values[i])) {
+          case Verdict::prime:
+            bitmap[i / 64] |= 1ull << (i % 64);
+            break;
+
+          case Verdict::unknown:
+            pending.push_back(i);
+            contexts.emplace_back(values[i]);
+            break;
+
+          case Verdict::composite:
+            break;
+        }
+      }
+
+      // Most composites fail the first base, so survivors are regrouped
+      // after every round to keep all lanes busy
+      for (std::uint64_t base : bases) {
+        std::size_t kept { 0 };
+
+        for (std::size_t g { 0 }; g < pending.size(); g += lanes) {
+          const int count { static_cast<int>(std::min<std::size_t>(lanes, pending.size() - g)) };
+          bool passed[lanes] { };
+
+          strongProbe(&contexts[g], count, base, passed);
+
+          for (int j { 0 }; j < count; ++j) {
+            if (passed[j]) {
+              pending[kept]  = pending[g + j];
+              contexts[kept] = contexts[g + j];
+              ++kept;
+            }
+          }
+        }
+
+        pending.resize(kept);
+        contexts.erase(contexts.begin() + static_cast<std::ptrdiff_t>(kept), contexts.end());
+      }
+
+      for (std::size_t i : pending)
+        bitmap[i / 64] |= 1ull << (i % 64);
+    }
+  }
+
+  bool isPrime64(std::uint64_t n) {
+    Verdict verdict { screen(n) };
+
+    if (verdict != Verdict::unknown)
+      return verdict == Verdict::prime;
+
+    const Montgomery mont { n };
+
+    for (std::uint64_t base : bases) {
+      bool passed { };
+      strongProbe(&mont, 1, base, &passed);
+
+      if (!passed)
+        return false;
+    }
+
+    return true;
+  }
+
+  std::vector<std::uint64_t> isPrimeBatch(std::span<const std::uint64_t> values, unsigned threads) {
+    std::vector<std::uint64_t> bitmap((values.size() + 63) / 64, 0);
+
+    if (threads == 0)
+      threads = std::max(1u, std::thread::hardware_concurrency());
+
+    // Chunks are whole bitmap words so no two threads share a word
+    const std::size_t words     { bitmap.size() };
+    const std::size_t perThread { (words + threads - 1) / std::max(1u, threads) };
+
+    std::vector<std::thread> workers { };
+
+    for (std::size_t w { 0 }; w < words; w += perThread) {
+      const std::size_t begin { w * 64 };
+      const std::size_t end   { std::min(values.size(), (w + perThread) * 64) };
+
+      workers.emplace_back(testRange, values, begin, end, bitmap.data());
+    }
+
+    for (std::thread& worker : workers)
+      worker.join();
+
+    return bitmap;
+  }
+}
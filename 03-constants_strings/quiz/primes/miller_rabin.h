@@ -0,0 +1,28 @@
+// +--------------------------------------------+
+// |        DETERMINISTIC MILLER-RABIN (64)     |
+// +--------------------------------------------+
+//
+// Primality for any 64-bit value without a sieve or sqrt(n) trial division.
+// The bases { 2, 325, 9375, 28178, 450775, 9780504, 1795265022 } have no
+// common strong pseudoprime below 2^64, so the answer is exact.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace Primes {
+  bool isPrime64(std::uint64_t n);
+
+  // Bit i of the result (word i / 64, bit i % 64) is set if values[i] is prime.
+  // Candidates are tested several at a time so their multiply chains overlap;
+  // threads = 0 uses every hardware thread.
+  std::vector<std::uint64_t> isPrimeBatch(std::span<const std::uint64_t> values,
+                                          unsigned threads = 0);
+
+  inline bool testBit(const std::vector<std::uint64_t>& bitmap, std::size_t i) {
+    return (bitmap[i / 64] >> (i % 64)) & 1;
+  }
+}
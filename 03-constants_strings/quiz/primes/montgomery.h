@@ -0,0 +1,55 @@
+// +--------------------------------------------+
+// |          MONTGOMERY ARITHMETIC (64)        |
+// +--------------------------------------------+
+//
+// Modular multiplication mod an odd n without any division.
+// Values are kept in "Montgomery form" (x * 2^64 mod n); a product needs
+// two 64x64->128 multiplies and a subtraction instead of a 128-bit modulo.
+
+#pragma once
+
+#include <cstdint>
+
+namespace Primes {
+  using u128 = unsigned __int128;
+
+  struct Montgomery {
+    std::uint64_t n    { }; // odd modulus
+    std::uint64_t nInv { }; // n^-1 mod 2^64
+    std::uint64_t r2   { }; // 2^128 mod n, converts into Montgomery form
+    std::uint64_t one  { }; // 1 in Montgomery form
+
+    explicit Montgomery(std::uint64_t modulus)
+      : n { modulus } {
+      // Newton iteration doubles the correct low bits each step (3 -> 96)
+      nInv = n;
+      for (int i { 0 }; i < 5; ++i)
+        nInv *= 2 - n * nInv;
+
+      one = static_cast<std::uint64_t>((static_cast<u128>(1) << 64) % n);
+      r2  = static_cast<std::uint64_t>(static_cast<u128>(one) * one % n);
+    }
+
+    // (t / 2^64) mod n for t < n * 2^64
+    std::uint64_t reduce(u128 t) const {
+      std::uint64_t m  { static_cast<std::uint64_t>(t) * nInv };
+      std::uint64_t hi { static_cast<std::uint64_t>(t >> 64) };
+      std::uint64_t mn { static_cast<std::uint64_t>((static_cast<u128>(m) * n) >> 64) };
+
+      return hi >= mn ? hi - mn : hi - mn + n;
+    }
+
+    std::uint64_t mul(std::uint64_t a, std::uint64_t b) const {
+      return reduce(static_cast<u128>(a) * b);
+    }
+
+    // (a + b) mod n for a, b < n; the sum can carry past 2^64 when n > 2^63
+    std::uint64_t add(std::uint64_t a, std::uint64_t b) const {
+      const std::uint64_t s { a + b };
+      return s < a || s >= n ? s - n : s;
+    }
+
+    std::uint64_t toMont(std::uint64_t x) const   { return mul(x % n, r2); }
+    std::uint64_t fromMont(std::uint64_t x) const { return reduce(x); }
+  };
+}
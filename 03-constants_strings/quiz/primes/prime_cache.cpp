@@ -0,0 +1,182 @@
+#include "prime_cache.h"
+#include "sieve.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace Primes {
+  namespace {
+    constexpr std::size_t   headerBytes   { 4096 };
+    constexpr std::uint64_t minimumGrowth { 1ull << 24 };
+
+    std::uint64_t roundUp128(std::uint64_t n) {
+      return n > ~0ull - 127 ? ~0ull / 128 * 128 : (n + 127) / 128 * 128;
+    }
+
+    std::size_t fileBytesFor(std::uint64_t limit) {
+      return headerBytes + static_cast<std::size_t>(limit / 16);
+    }
+
+    bool headerIsValid(const CacheHeader& header, std::size_t fileBytes) {
+      const CacheHeader expected { };
+
+      return std::memcmp(header.magic, expected.magic, sizeof(header.magic)) == 0
+          && header.version     == expected.version
+          && header.headerBytes == headerBytes
+          && header.limit % 128 == 0
+          && fileBytesFor(header.limit) <= fileBytes;
+    }
+
+    // Holds an flock() for the lifetime of the object
+    class FileLock {
+    public:
+      FileLock(int fd, int operation)
+        : m_fd { fd } { flock(m_fd, operation); }
+
+      ~FileLock() { flock(m_fd, LOCK_UN); }
+
+    private:
+      int m_fd;
+    };
+  }
+
+  PrimeCache::PrimeCache(const std::string& path, std::uint64_t maxLimit)
+    : m_maxLimit { roundUp128(maxLimit) } {
+    m_fd = open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+
+    if (m_fd < 0)
+      return;
+
+    FileLock lock { m_fd, LOCK_EX };
+
+    struct stat info { };
+    if (fstat(m_fd, &info) != 0) {
+      close(m_fd);
+      m_fd = -1;
+      return;
+    }
+
+    CacheHeader header { };
+    const bool readable {
+      static_cast<std::size_t>(info.st_size) >= headerBytes
+        && pread(m_fd, &header, sizeof(header), 0) == static_cast<ssize_t>(sizeof(header))
+    };
+
+    if (!readable || !headerIsValid(header, static_cast<std::size_t>(info.st_size))) {
+      rebuild();
+      return;
+    }
+
+    if (map(static_cast<std::size_t>(info.st_size)))
+      m_mappedLimit = header.limit;
+  }
+
+  PrimeCache::~PrimeCache() {
+    unmap();
+
+    if (m_fd >= 0)
+      close(m_fd);
+  }
+
+  std::uint64_t PrimeCache::limit() const {
+    if (!m_map)
+      return 0;
+
+    auto* header { reinterpret_cast<CacheHeader*>(m_map) };
+    return std::atomic_ref<std::uint64_t> { header->limit }.load(std::memory_order_acquire);
+  }
+
+  bool PrimeCache::map(std::size_t bytes) {
+    unmap();
+
+    void* address { mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, m_fd, 0) };
+
+    if (address == MAP_FAILED)
+      return false;
+
+    m_map      = static_cast<std::uint8_t*>(address);
+    m_mapBytes = bytes;
+    m_words    = reinterpret_cast<const std::uint64_t*>(m_map + headerBytes);
+
+    return true;
+  }
+
+  void PrimeCache::unmap() {
+    if (m_map)
+      munmap(m_map, m_mapBytes);
+
+    m_map         = nullptr;
+    m_mapBytes    = 0;
+    m_words       = nullptr;
+    m_mappedLimit = 0;
+  }
+
+  // Caller holds the exclusive lock
+  void PrimeCache::rebuild() {
+    const CacheHeader header { };
+
+    if (ftruncate(m_fd, 0) != 0 || ftruncate(m_fd, headerBytes) != 0)
+      return;
+
+    if (pwrite(m_fd, &header, sizeof(header), 0) != static_cast<ssize_t>(sizeof(header)))
+      return;
+
+    if (map(headerBytes))
+      m_mappedLimit = 0;
+  }
+
+  void PrimeCache::extendTo(std::uint64_t newLimit) {
+    newLimit = std::min(newLimit, m_maxLimit);
+
+    if (m_fd < 0 || newLimit <= m_mappedLimit)
+      return;
+
+    FileLock lock { m_fd, LOCK_EX };
+
+    // Another process may already have grown the file
+    struct stat info { };
+    if (fstat(m_fd, &info) != 0)
+      return;
+
+    CacheHeader header { };
+    if (pread(m_fd, &header, sizeof(header), 0) != static_cast<ssize_t>(sizeof(header))
+        || !headerIsValid(header, static_cast<std::size_t>(info.st_size)))
+      return;
+
+    if (header.limit >= newLimit) {
+      if (map(static_cast<std::size_t>(info.st_size)))
+        m_mappedLimit = header.limit;
+      return;
+    }
+
+    // Grow geometrically so a run of rising queries sieves O(log n) times,
+    // but not past maxLimit
+    const std::uint64_t target { roundUp128(std::min(std::max({ newLimit, header.limit * 2, minimumGrowth }), m_maxLimit)) };
+
+    const std::size_t bytes { fileBytesFor(target) };
+
+    if (ftruncate(m_fd, static_cast<off_t>(bytes)) != 0 || !map(bytes))
+      return;
+
+    // New pages read back as zero, so only the primes need writing
+    auto* words { reinterpret_cast<std::uint64_t*>(m_map + headerBytes) };
+
+    SegmentedSieve { target }.forEachPrime(header.limit, target, [&](std::uint64_t p) {
+      if (p != 2)
+        words[p / 128] |= 1ull << ((p / 2) % 64);
+    });
+
+    // Publish the new range only once its bits are in place
+    auto* mapped { reinterpret_cast<CacheHeader*>(m_map) };
+    std::atomic_ref<std::uint64_t> { mapped->limit }.store(target, std::memory_order_release);
+
+    m_mappedLimit = target;
+  }
+}
@@ -0,0 +1,77 @@
+// +--------------------------------------------+
+// |       PERSISTENT PRIME BITMAP (MMAP)       |
+// +--------------------------------------------+
+//
+// An on-disk bitmap of odd primes that later runs map instead of recomputing.
+// Bit i of the data stands for the odd number 2 * i + 1.
+//
+// File layout:
+//   [0, 4096)   CacheHeader (rest of the page is zero)
+//   [4096, ...) uint64_t words, little-endian, covering [0, limit)
+//
+// A lookup is a bit test on a page-cache page. A query at or past `limit`
+// sieves the missing range, grows the file and remaps it, up to maxLimit
+// (2^32 by default, a 256 MiB file); larger numbers go to isPrime64
+// instead of growing the file to match.
+
+#pragma once
+
+#include "miller_rabin.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace Primes {
+  struct CacheHeader {
+    char          magic[8]    { 'P', 'R', 'I', 'M', 'E', 'B', 'M', 'P' };
+    std::uint32_t version     { 1 };
+    std::uint32_t headerBytes { 4096 };
+    std::uint64_t limit       { 0 }; // every n < limit is answered by the bitmap
+  };
+
+  class PrimeCache {
+  public:
+    // Opens (or creates) the cache file; check isOpen() before use
+    explicit PrimeCache(const std::string& path, std::uint64_t maxLimit = 1ull << 32);
+    ~PrimeCache();
+
+    PrimeCache(const PrimeCache&) = delete;
+    PrimeCache& operator=(const PrimeCache&) = delete;
+
+    bool isOpen() const { return m_map != nullptr; }
+
+    // Numbers below this are already on disk
+    std::uint64_t limit() const;
+
+    bool isPrime(std::uint64_t n) {
+      if (n >= m_mappedLimit && n < m_maxLimit)
+        extendTo(n + 1);
+
+      // Past maxLimit, or the file could not grow (disk full, read-only, ...)
+      if (n >= m_mappedLimit)
+        return isPrime64(n);
+
+      if (n < 3)
+        return n == 2;
+
+      return (n & 1) && ((m_words[n / 128] >> ((n / 2) % 64)) & 1);
+    }
+
+    // Makes every n < min(newLimit, maxLimit) available, sieving only what
+    // is missing
+    void extendTo(std::uint64_t newLimit);
+
+  private:
+    bool map(std::size_t bytes);
+    void unmap();
+    void rebuild();
+
+    int                  m_fd          { -1 };
+    std::uint8_t*        m_map         { nullptr };
+    std::size_t          m_mapBytes    { 0 };
+    const std::uint64_t* m_words       { nullptr };
+    std::uint64_t        m_mappedLimit { 0 }; // limit seen by this mapping
+    std::uint64_t        m_maxLimit    { 0 }; // the file never grows past this
+  };
+}
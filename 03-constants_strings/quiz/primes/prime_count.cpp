@@ -0,0 +1,369 @@
+#include "prime_count.h"
+#include "sieve.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <limits>
+#include <thread>
+#include <vector>
+
+namespace Primes {
+  namespace {
+    using i64 = std::int64_t;
+
+    // Below this a plain sieve count is faster than setting up the leaves
+    constexpr std::uint64_t directLimit { 10'000'000 };
+
+    // Bits per sieve segment of the special-leaf sieve
+    constexpr std::uint64_t lmoSegmentBits { 1u << 18 };
+
+    std::uint64_t isqrt(std::uint64_t n) {
+      std::uint64_t r { static_cast<std::uint64_t>(std::sqrt(static_cast<long double>(n))) };
+
+      while (r * r > n)
+        --r;
+      while ((r + 1) * (r + 1) <= n)
+        ++r;
+
+      return r;
+    }
+
+    std::uint64_t icbrt(std::uint64_t n) {
+      std::uint64_t r { static_cast<std::uint64_t>(std::cbrt(static_cast<long double>(n))) };
+
+      while (r * r * r > n)
+        --r;
+      while ((r + 1) * (r + 1) * (r + 1) <= n)
+        ++r;
+
+      return r;
+    }
+
+    struct Context {
+      std::uint64_t x { };
+      std::uint64_t y { };               // leaf bound, x^(1/3) <= y <= sqrt(x)
+      std::uint64_t z { };               // the sieve covers [0, z), z = x / y + 1
+      std::uint64_t a { };               // pi(y)
+
+      std::vector<std::uint32_t> primes; // primes[1] = 2, ... up to sqrt(x); primes[0] unused
+      std::vector<std::int8_t>   mu;     // Moebius function on [0, y]
+      std::vector<std::uint32_t> lpf;    // least prime factor on [0, y], lpf[1] = max
+    };
+
+    // What one chunk of the sieve contributes. Leaf and P2 sums are taken as if
+    // the chunk started at 0; the per-k totals let the caller shift them later.
+    struct ChunkResult {
+      i64                        leafSum   { };
+      std::vector<i64>           leafSigns { }; // [k] sum of -mu(m) over leaves needing phi(., k)
+      std::vector<std::uint64_t> counts    { }; // [k] survivors in the chunk once k primes are removed
+      i64                        p2Sum     { };
+      std::uint64_t              p2Terms   { };
+    };
+
+    Context makeContext(std::uint64_t x) {
+      Context ctx { };
+      ctx.x = x;
+
+      // A y above x^(1/3) trades special leaves for a shorter sieve
+      const double alpha { std::max(1.0, std::log(static_cast<double>(x)) / 12.0) };
+      ctx.y = std::min(isqrt(x), static_cast<std::uint64_t>(alpha * static_cast<double>(icbrt(x))));
+      ctx.y = std::max(ctx.y, icbrt(x) + 1);
+      ctx.z = x / ctx.y + 1;
+
+      const std::uint64_t root { isqrt(x) };
+      const SegmentedSieve sieve { root + 1 };
+
+      ctx.primes.push_back(0);
+      sieve.forEachPrime(0, root + 1, [&](std::uint64_t p) {
+        ctx.primes.push_back(static_cast<std::uint32_t>(p));
+      });
+
+      ctx.a = static_cast<std::uint64_t>(
+        std::upper_bound(ctx.primes.begin() + 1, ctx.primes.end(), ctx.y) - (ctx.primes.begin() + 1));
+
+      ctx.mu.assign(ctx.y + 1, 1);
+      ctx.lpf.assign(ctx.y + 1, 0);
+      ctx.lpf[1] = std::numeric_limits<std::uint32_t>::max();
+
+      for (std::uint64_t b { 1 }; b <= ctx.a; ++b) {
+        const std::uint64_t p { ctx.primes[b] };
+
+        for (std::uint64_t m { p }; m <= ctx.y; m += p) {
+          if (ctx.lpf[m] == 0)
+            ctx.lpf[m] = static_cast<std::uint32_t>(p);
+
+          ctx.mu[m] = static_cast<std::int8_t>(-ctx.mu[m]);
+        }
+
+        for (std::uint64_t m { p * p }; m <= ctx.y; m += p * p)
+          ctx.mu[m] = 0;
+      }
+
+      return ctx;
+    }
+
+    // Counts set bits at positions <= t, moving forward through the segment.
+    // Queries must arrive in increasing t.
+    class Cursor {
+    public:
+      explicit Cursor(const std::vector<std::uint64_t>& bits)
+        : m_bits { bits } { }
+
+      std::uint64_t countUpTo(std::uint64_t t) {
+        const std::size_t word { static_cast<std::size_t>(t / 64) };
+
+        for (; m_word < word; ++m_word)
+          m_count += static_cast<std::uint64_t>(__builtin_popcountll(m_bits[m_word]));
+
+        const std::uint64_t mask { (2ull << (t % 64)) - 1 };
+        return m_count + static_cast<std::uint64_t>(__builtin_popcountll(m_bits[word] & mask));
+      }
+
+    private:
+      const std::vector<std::uint64_t>& m_bits;
+      std::size_t   m_word  { 0 };
+      std::uint64_t m_count { 0 };
+    };
+
+    ChunkResult sieveChunk(const Context& ctx, std::uint64_t low, std::uint64_t high) {
+      const std::uint64_t x { ctx.x };
+      const std::uint64_t y { ctx.y };
+      const std::uint64_t a { ctx.a };
+      const std::uint64_t sqrtY { isqrt(y) };
+      const auto& primes { ctx.primes };
+
+      ChunkResult result { };
+      result.leafSigns.assign(a + 1, 0);
+      result.counts.assign(a + 1, 0);
+
+      std::vector<std::uint64_t> bits(lmoSegmentBits / 64);
+      std::vector<std::uint64_t> next(a + 1);
+
+      for (std::uint64_t b { 1 }; b <= a; ++b)
+        next[b] = (low + primes[b] - 1) / primes[b] * primes[b];
+
+      for (std::uint64_t segLow { low }; segLow < high; segLow += lmoSegmentBits) {
+        const std::uint64_t segHigh { std::min(segLow + lmoSegmentBits, high) };
+        const std::uint64_t length  { segHigh - segLow };
+
+        std::fill(bits.begin(), bits.end(), 0);
+        std::fill(bits.begin(), bits.begin() + static_cast<std::ptrdiff_t>(length / 64), ~0ull);
+        if (length % 64)
+          bits[length / 64] = (1ull << (length % 64)) - 1;
+
+        std::uint64_t count { length };
+
+        if (segLow == 0) {
+          bits[0] &= ~1ull; // 0 is not counted by phi
+          --count;
+        }
+
+        for (std::uint64_t k { 0 }; k <= a; ++k) {
+          // Special leaves -mu(m) * phi(x / (m * p_b), b - 1) with b = k + 1:
+          // y < m * p_b, m <= y, lpf(m) > p_b, v = x / (m * p_b) in this segment
+          if (k + 1 < a) {
+            const std::uint64_t b { k + 1 };
+            const std::uint64_t p { primes[b] };
+
+            const std::uint64_t mMax { segLow == 0 ? y : std::min(y, x / (p * segLow)) };
+            const std::uint64_t mMin { std::max({ y / p, x / (p * segHigh), p }) + 1 };
+
+            if (mMin <= mMax) {
+              Cursor cursor { bits };
+              const std::uint64_t before { result.counts[k] };
+
+              auto addLeaf = [&](std::uint64_t m) {
+                const std::uint64_t v     { x / (p * m) };
+                const i64           sign  { -ctx.mu[m] };
+                const std::uint64_t phi   { before + cursor.countUpTo(v - segLow) };
+
+                result.leafSum      += sign * static_cast<i64>(phi);
+                result.leafSigns[k] += sign;
+              };
+
+              // Decreasing m visits increasing v, which the cursor needs
+              if (p <= sqrtY) {
+                for (std::uint64_t m { mMax }; m >= mMin; --m) {
+                  if (ctx.mu[m] != 0 && ctx.lpf[m] > p)
+                    addLeaf(m);
+                }
+              }
+
+              else {
+                // Above sqrt(y), a squarefree m <= y with lpf(m) > p is a prime
+                auto first { std::lower_bound(primes.begin() + 1, primes.begin() + static_cast<std::ptrdiff_t>(a) + 1, mMin) };
+                auto last  { std::upper_bound(first, primes.begin() + static_cast<std::ptrdiff_t>(a) + 1, mMax) };
+
+                while (last != first)
+                  addLeaf(*--last);
+              }
+            }
+          }
+
+          // With all a primes removed, only 1 and the primes in (y, z) survive,
+          // so the counts give pi(x / p_b) for the P2 terms
+          if (k == a) {
+            const std::uint64_t pMin { std::max(y, x / segHigh) };
+            const std::uint64_t pMax { segLow == 0 ? x : x / segLow };
+
+            auto first { std::upper_bound(primes.begin() + static_cast<std::ptrdiff_t>(a) + 1, primes.end(), pMin) };
+            auto last  { std::upper_bound(first, primes.end(), pMax) };
+
+            Cursor cursor { bits };
+
+            while (last != first) {
+              --last;
+
+              const std::uint64_t b     { static_cast<std::uint64_t>(last - primes.begin()) };
+              const std::uint64_t v     { x / *last };
+              const std::uint64_t piV   { a - 1 + result.counts[a] + cursor.countUpTo(v - segLow) };
+
+              result.p2Sum += static_cast<i64>(piV) - static_cast<i64>(b) + 1;
+              ++result.p2Terms;
+            }
+          }
+
+          result.counts[k] += count;
+
+          if (k < a) {
+            const std::uint64_t p { primes[k + 1] };
+            std::uint64_t m { next[k + 1] };
+
+            for (; m < segHigh; m += p) {
+              const std::uint64_t t    { m - segLow };
+              const std::uint64_t mask { 1ull << (t % 64) };
+
+              count -= (bits[t / 64] & mask) != 0;
+              bits[t / 64] &= ~mask;
+            }
+
+            next[k + 1] = m;
+          }
+        }
+      }
+
+      return result;
+    }
+
+    std::uint64_t lmo(std::uint64_t x, unsigned threads) {
+      const Context ctx { makeContext(x) };
+      const std::uint64_t a { ctx.a };
+
+      // Ordinary leaves: mu(n) * floor(x / n) for every n <= y
+      i64 phi { 0 };
+      for (std::uint64_t n { 1 }; n <= ctx.y; ++n)
+        phi += ctx.mu[n] * static_cast<i64>(x / n);
+
+      // Several chunks per thread so that slow chunks (many leaves) even out
+      const std::uint64_t segments       { (ctx.z + lmoSegmentBits - 1) / lmoSegmentBits };
+      const std::uint64_t chunkCount     { std::min<std::uint64_t>(segments, threads * 8ull) };
+      const std::uint64_t segsPerChunk   { (segments + chunkCount - 1) / chunkCount };
+
+      std::vector<ChunkResult> results(chunkCount);
+      std::atomic<std::uint64_t> nextChunk { 0 };
+
+      auto worker = [&] {
+        for (std::uint64_t c { nextChunk++ }; c < chunkCount; c = nextChunk++) {
+          const std::uint64_t low  { c * segsPerChunk * lmoSegmentBits };
+          const std::uint64_t high { std::min(ctx.z, (c + 1) * segsPerChunk * lmoSegmentBits) };
+
+          if (low < high)
+            results[c] = sieveChunk(ctx, low, high);
+        }
+      };
+
+      std::vector<std::thread> pool { };
+      for (unsigned t { 1 }; t < threads; ++t)
+        pool.emplace_back(worker);
+
+      worker();
+
+      for (std::thread& t : pool)
+        t.join();
+
+      // Shift every chunk by the survivors of all chunks before it
+      std::vector<std::uint64_t> before(a + 1, 0);
+      i64 p2 { 0 };
+
+      for (const ChunkResult& r : results) {
+        if (r.counts.empty())
+          continue;
+
+        phi += r.leafSum;
+        p2  += r.p2Sum + static_cast<i64>(r.p2Terms * before[a]);
+
+        for (std::uint64_t k { 0 }; k <= a; ++k) {
+          phi       += r.leafSigns[k] * static_cast<i64>(before[k]);
+          before[k] += r.counts[k];
+        }
+      }
+
+      return static_cast<std::uint64_t>(phi + static_cast<i64>(a) - 1 - p2);
+    }
+
+    // Cipolla's asymptotic estimate of the n-th prime
+    std::uint64_t estimateNthPrime(std::uint64_t n) {
+      const double dn     { static_cast<double>(n) };
+      const double logN   { std::log(dn) };
+      const double logLog { std::log(logN) };
+
+      return static_cast<std::uint64_t>(dn * (logN + logLog - 1.0 + (logLog - 2.0) / logN));
+    }
+  }
+
+  std::uint64_t primePi(std::uint64_t x, unsigned threads) {
+    if (x < directLimit)
+      return SegmentedSieve { x + 1 }.countPrimes(0, x + 1);
+
+    if (threads == 0)
+      threads = std::max(1u, std::thread::hardware_concurrency());
+
+    return lmo(x, threads);
+  }
+
+  std::uint64_t nthPrime(std::uint64_t n, unsigned threads) {
+    if (n == 0)
+      return 0;
+
+    if (n < 100'000) {
+      const std::uint64_t bound { n < 6 ? 13 : estimateNthPrime(n) * 11 / 10 + 100 };
+      std::vector<std::uint64_t> primes { SegmentedSieve { bound + 1 }.primesInRange(0, bound + 1) };
+
+      return primes[n - 1];
+    }
+
+    // Count up to the estimate, then walk windows of the sieve toward the answer
+    const std::uint64_t guess { estimateNthPrime(n) };
+    const std::uint64_t count { primePi(guess, threads) };
+    const std::uint64_t window { std::max<std::uint64_t>(1u << 20, guess / 10'000) };
+
+    const SegmentedSieve sieve { guess + guess / 10 + window };
+
+    if (count < n) {
+      std::uint64_t remaining { n - count };
+
+      for (std::uint64_t lo { guess + 1 }; ; lo += window) {
+        std::vector<std::uint64_t> primes { sieve.primesInRange(lo, lo + window) };
+
+        if (remaining <= primes.size())
+          return primes[remaining - 1];
+
+        remaining -= primes.size();
+      }
+    }
+
+    // count >= n: the answer is the (count - n)-th prime at or below guess, counting down
+    std::uint64_t skip { count - n };
+
+    for (std::uint64_t hi { guess + 1 }; ; hi -= std::min(hi, window)) {
+      const std::uint64_t lo { hi > window ? hi - window : 0 };
+      std::vector<std::uint64_t> primes { sieve.primesInRange(lo, hi) };
+
+      if (skip < primes.size())
+        return primes[primes.size() - 1 - skip];
+
+      skip -= primes.size();
+    }
+  }
+}
@@ -0,0 +1,26 @@
+// +--------------------------------------------+
+// |        PRIME COUNTING pi(x) & NTH PRIME    |
+// +--------------------------------------------+
+//
+// Counts primes without listing them, using the Lagarias-Miller-Odlyzko
+// form of Meissel-Lehmer:
+//
+//   pi(x) = phi(x, a) + a - 1 - P2(x, a),   a = pi(y),  y ~ x^(1/3)
+//
+// phi(x, a) counts n <= x with no prime factor among the first a primes.
+// It splits into "ordinary" leaves (a plain sum over n <= y) and "special"
+// leaves, which are answered by a segmented sieve over [1, x / y).
+// P2 counts n <= x with exactly two prime factors above y, and reads its
+// pi values from the same sieve. Total work is about x^(2/3).
+
+#pragma once
+
+#include <cstdint>
+
+namespace Primes {
+  // Number of primes p <= x; threads = 0 uses every hardware thread
+  std::uint64_t primePi(std::uint64_t x, unsigned threads = 0);
+
+  // The n-th prime (nthPrime(1) == 2): pi(x) near an estimate, then a local sieve
+  std::uint64_t nthPrime(std::uint64_t n, unsigned threads = 0);
+}
@@ -0,0 +1,192 @@
+// +--------------------------------------------+
+// |     MULTI-PROCESS SHARED-MEMORY SIEVE      |
+// +--------------------------------------------+
+//
+// Splits [0, hi) across forked worker processes. Every worker sieves its own
+// byte range of the wheel bitmap (see sieve.h) straight into one POSIX
+// shared-memory object, so the parent never copies results back.
+// A worker that crashes only loses its own range, which is handed to a fresh
+// worker once.
+//
+// g++ -std=c++20 -O2 -march=native -pthread sieve.cpp miller_rabin.cpp shm_sieve.cpp -o shm_sieve
+// ./shm_sieve [hi] [workers]   (defaults: 1e10, every core)
+// ./shm_sieve [hi] scaling     (runs 1 .. cores workers and prints the curve)
+
+#include "sieve.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace {
+  struct SharedBitmap {
+    std::uint8_t* bytes { nullptr };
+    std::size_t   size  { 0 };
+  };
+
+  // The name is unlinked right after mapping: the children inherit the
+  // mapping through fork and nothing is left behind if the parent dies
+  SharedBitmap createSharedBitmap(std::size_t size) {
+    const std::string name { "/necronomicon-sieve-" + std::to_string(getpid()) };
+    const int fd { shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600) };
+
+    if (fd < 0)
+      return { };
+
+    shm_unlink(name.c_str());
+
+    if (ftruncate(fd, static_cast<off_t>(size)) != 0) {
+      close(fd);
+      return { };
+    }
+
+    void* address { mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0) };
+    close(fd);
+
+    if (address == MAP_FAILED)
+      return { };
+
+    return { static_cast<std::uint8_t*>(address), size };
+  }
+
+  struct Range {
+    std::uint64_t firstByte { };
+    std::uint64_t endByte   { };
+  };
+
+  pid_t spawnWorker(const Primes::SegmentedSieve& sieve, SharedBitmap bitmap, Range range, std::uint64_t hi) {
+    const pid_t pid { fork() };
+
+    if (pid != 0)
+      return pid;
+
+    sieve.sieveInto(range.firstByte * 30, std::min(hi, range.endByte * 30), bitmap.bytes);
+
+    _exit(0);
+  }
+
+  // Returns the wall time in seconds, or a negative value if a range failed twice
+  double runWorkers(const Primes::SegmentedSieve& sieve, SharedBitmap bitmap, std::uint64_t hi, unsigned workers) {
+    const auto start { std::chrono::steady_clock::now() };
+
+    // Ranges are whole segments, so no two workers ever write the same byte
+    const std::uint64_t totalBytes   { bitmap.size };
+    const std::uint64_t segments     { (totalBytes + Primes::segmentBytes - 1) / Primes::segmentBytes };
+    const std::uint64_t perWorker    { (segments + workers - 1) / workers };
+
+    std::vector<std::pair<pid_t, Range>> running { };
+
+    for (unsigned w { 0 }; w < workers; ++w) {
+      const Range range {
+        std::min(totalBytes, w * perWorker * Primes::segmentBytes),
+        std::min(totalBytes, (w + 1) * perWorker * Primes::segmentBytes)
+      };
+
+      if (range.firstByte < range.endByte)
+        running.emplace_back(spawnWorker(sieve, bitmap, range, hi), range);
+    }
+
+    for (int attempt { 0 }; attempt < 2 && !running.empty(); ++attempt) {
+      std::vector<std::pair<pid_t, Range>> failed { };
+
+      for (auto& [pid, range] : running) {
+        int status { };
+
+        if (pid < 0 || waitpid(pid, &status, 0) != pid || !WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+          std::cout << "worker for bytes [" << range.firstByte << ", " << range.endByte << ") failed\n";
+          failed.emplace_back(pid, range);
+        }
+      }
+
+      running.clear();
+
+      if (attempt == 0) {
+        for (auto& [pid, range] : failed)
+          running.emplace_back(spawnWorker(sieve, bitmap, range, hi), range);
+      }
+
+      else if (!failed.empty()) {
+        return -1.0;
+      }
+    }
+
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  }
+
+  std::uint64_t countPrimes(SharedBitmap bitmap, std::uint64_t hi) {
+    std::uint64_t count { 0 };
+
+    for (std::uint64_t p : { 2u, 3u, 5u })
+      count += p < hi;
+
+    std::size_t i { 0 };
+
+    for (; i + 8 <= bitmap.size; i += 8) {
+      std::uint64_t word { };
+      std::memcpy(&word, bitmap.bytes + i, 8);
+      count += static_cast<std::uint64_t>(__builtin_popcountll(word));
+    }
+
+    for (; i < bitmap.size; ++i)
+      count += static_cast<std::uint64_t>(__builtin_popcount(bitmap.bytes[i]));
+
+    return count;
+  }
+}
+
+int main(int argc, char** argv) {
+  const std::uint64_t hi    { argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 10'000'000'000ull };
+  const unsigned      cores { static_cast<unsigned>(std::max(1L, sysconf(_SC_NPROCESSORS_ONLN))) };
+  const bool          scaling { argc > 2 && std::string { argv[2] } == "scaling" };
+  const unsigned      workers { argc > 2 && !scaling ? static_cast<unsigned>(std::strtoul(argv[2], nullptr, 10)) : cores };
+
+  // Built once before forking; the children share its pages copy-on-write
+  const Primes::SegmentedSieve sieve { hi };
+
+  SharedBitmap bitmap { createSharedBitmap(static_cast<std::size_t>((hi + 29) / 30)) };
+
+  if (!bitmap.bytes) {
+    std::cout << "could not create the shared bitmap\n";
+    return 1;
+  }
+
+  const unsigned first { scaling ? 1u : std::max(1u, workers) };
+  const unsigned last  { scaling ? cores : first };
+  double baseline { 0.0 };
+
+  for (unsigned w { first }; w <= last; ++w) {
+    const double seconds { runWorkers(sieve, bitmap, hi, w) };
+
+    if (seconds < 0.0) {
+      std::cout << "giving up: a range failed twice\n";
+      return 1;
+    }
+
+    std::cout << w << " workers: " << countPrimes(bitmap, hi) << " primes below " << hi
+              << " in " << seconds << " s";
+
+    // Speedup is relative to the single-worker run of the same sweep
+    if (scaling) {
+      if (w == 1)
+        baseline = seconds;
+
+      std::cout << ", speedup " << baseline / seconds << ", efficiency " << baseline / seconds / w;
+    }
+
+    std::cout << '\n';
+  }
+
+  munmap(bitmap.bytes, bitmap.size);
+
+  return 0;
+}
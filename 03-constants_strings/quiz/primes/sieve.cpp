@@ -0,0 +1,316 @@
+#include "sieve.h"
+#include "miller_rabin.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace Primes {
+  namespace {
+    // Multiples of these primes are cleared by copying a repeating pattern
+    constexpr std::uint32_t presievePrimes[] { 7, 11, 13, 17 };
+    constexpr std::size_t   patternBytes     { 7 * 11 * 13 * 17 };
+
+    // Bit index for a residue mod 30 (only meaningful for the 8 wheel residues)
+    constexpr auto bitForResidue {
+      [] {
+        struct Table { std::uint8_t bit[30] { }; } table { };
+
+        for (std::uint8_t i { 0 }; i < 8; ++i)
+          table.bit[wheelResidues[i]] = i;
+
+        return table;
+      }()
+    };
+
+    // Per (p mod 30, cofactor wheel index) tables for crossing off p * m:
+    // clear  - mask that removes p * m from its byte
+    // gap    - distance to the next cofactor coprime to 30
+    // carry  - extra bytes the next multiple moves on top of (p / 30) * gap
+    constexpr auto wheelSteps {
+      [] {
+        struct Tables {
+          std::uint8_t clear[30][8] { };
+          std::uint8_t gap[8]       { };
+          std::uint8_t carry[30][8] { };
+        } t { };
+
+        for (int k { 0 }; k < 8; ++k) {
+          const int m    { wheelResidues[k] };
+          const int next { k < 7 ? wheelResidues[k + 1] : 31 };
+          t.gap[k] = static_cast<std::uint8_t>(next - m);
+
+          for (int pr : wheelResidues) {
+            t.clear[pr][k] = static_cast<std::uint8_t>(~(1u << bitForResidue.bit[pr * m % 30]));
+            t.carry[pr][k] = static_cast<std::uint8_t>(pr * next / 30 - pr * m / 30);
+          }
+        }
+
+        return t;
+      }()
+    };
+
+    struct LargePrime {
+      std::uint32_t prime  { };
+      std::uint32_t offset { }; // next multiple, bytes from the segment start
+      std::uint8_t  wheel  { }; // wheel index of that multiple's cofactor
+    };
+
+    std::uint64_t isqrt(std::uint64_t n) {
+      std::uint64_t r { static_cast<std::uint64_t>(__builtin_sqrtl(static_cast<long double>(n))) };
+
+      while (r * r > n)
+        --r;
+      while ((r + 1) * (r + 1) <= n)
+        ++r;
+
+      return r;
+    }
+
+    // Plain odd-only sieve, used once to find the base primes
+    std::vector<std::uint32_t> smallPrimes(std::uint32_t limit) {
+      std::vector<std::uint32_t> primes { };
+      std::vector<bool> composite(limit / 2 + 1, false);
+
+      for (std::uint64_t i { 3 }; i * i <= limit; i += 2) {
+        if (!composite[i / 2]) {
+          for (std::uint64_t j { i * i }; j <= limit; j += 2 * i)
+            composite[j / 2] = true;
+        }
+      }
+
+      for (std::uint32_t i { 7 }; i <= limit; i += 2) {
+        if (!composite[i / 2])
+          primes.push_back(i);
+      }
+
+      return primes;
+    }
+
+    const std::vector<std::uint8_t>& presievePattern() {
+      static const std::vector<std::uint8_t> pattern {
+        [] {
+          std::vector<std::uint8_t> bytes(patternBytes, 0xFF);
+
+          for (std::uint32_t p : presievePrimes) {
+            for (std::uint64_t n { p }; n < patternBytes * 30; n += 2 * p) {
+              std::uint32_t r { static_cast<std::uint32_t>(n % 30) };
+
+              if (r % 3 != 0 && r % 5 != 0)
+                bytes[n / 30] &= static_cast<std::uint8_t>(~(1u << bitForResidue.bit[r]));
+            }
+          }
+
+          return bytes;
+        }()
+      };
+
+      return pattern;
+    }
+
+    // Copies the presieved pattern into seg, starting at absolute byte index first
+    void fillFromPattern(std::uint8_t* seg, std::size_t length, std::uint64_t first) {
+      const std::uint8_t* pattern { presievePattern().data() };
+      std::size_t offset { static_cast<std::size_t>(first % patternBytes) };
+
+      while (length > 0) {
+        std::size_t chunk { std::min(length, patternBytes - offset) };
+        std::memcpy(seg, pattern + offset, chunk);
+
+        seg    += chunk;
+        length -= chunk;
+        offset  = 0;
+      }
+    }
+  }
+
+  SegmentedSieve::SegmentedSieve(std::uint64_t limit)
+    : m_limit { limit } {
+    std::uint64_t root { isqrt(limit) };
+    std::vector<std::uint32_t> primes { smallPrimes(static_cast<std::uint32_t>(root)) };
+
+    // 7..17 are handled by the presieve pattern
+    for (std::uint32_t p : primes) {
+      if (p > presievePrimes[std::size(presievePrimes) - 1])
+        m_basePrimes.push_back(p);
+    }
+  }
+
+  void SegmentedSieve::forEachSegment(std::uint64_t lo, std::uint64_t hi,
+                                      const std::function<void(const Segment&)>& visit) const {
+    sieve(lo, hi, nullptr, visit);
+  }
+
+  void SegmentedSieve::sieveInto(std::uint64_t lo, std::uint64_t hi, std::uint8_t* bitmap) const {
+    sieve(lo, hi, bitmap, { });
+  }
+
+  void SegmentedSieve::sieve(std::uint64_t lo, std::uint64_t hi, std::uint8_t* bitmap,
+                             const std::function<void(const Segment&)>& visit) const {
+    hi = std::min(hi, m_limit);
+
+    if (lo >= hi)
+      return;
+
+    const std::uint64_t firstByte { lo / 30 };
+    const std::uint64_t endByte   { (hi + 29) / 30 };
+
+    // Segments are sieved in the caller's bitmap when there is one
+    std::vector<std::uint8_t> buffer(bitmap ? 0 : segmentBytes);
+
+    // Primes below the segment size hit every segment, so each keeps one
+    // offset per wheel class of its cofactor and crosses off with stride p.
+    // Larger primes hit a segment at most a few times; they walk their
+    // multiples in wheel order with a single offset instead.
+    std::vector<std::uint32_t> smallOffsets { };
+    std::vector<LargePrime>    large        { };
+    std::size_t active { 0 };
+
+    for (std::uint64_t segStart { firstByte }; segStart < endByte; segStart += segmentBytes) {
+      const std::size_t   length { static_cast<std::size_t>(std::min<std::uint64_t>(segmentBytes, endByte - segStart)) };
+      const std::uint64_t segLo  { segStart * 30 };
+      const std::uint64_t segHi  { (segStart + length) * 30 };
+      std::uint8_t* const seg    { bitmap ? bitmap + segStart : buffer.data() };
+
+      fillFromPattern(seg, length, segStart);
+
+      // Activate primes whose square now falls before the end of this segment
+      while (active < m_basePrimes.size()) {
+        const std::uint64_t p { m_basePrimes[active] };
+
+        if (p * p >= segHi)
+          break;
+
+        const std::uint64_t mMin { std::max(p, (segLo + p - 1) / p) };
+
+        if (p < segmentBytes) {
+          for (int k { 0 }; k < 8; ++k) {
+            const std::uint64_t r { wheelResidues[k] };
+            const std::uint64_t m { mMin + (r + 30 - mMin % 30) % 30 };
+            smallOffsets.push_back(static_cast<std::uint32_t>(p * m / 30 - segStart));
+          }
+        }
+
+        else {
+          // Smallest cofactor m >= mMin that is coprime to 30
+          std::uint64_t m { mMin };
+          while (bitForResidue.bit[m % 30] == 0 && m % 30 != 1)
+            ++m;
+
+          large.push_back(LargePrime {
+            static_cast<std::uint32_t>(p),
+            static_cast<std::uint32_t>(p * m / 30 - segStart),
+            bitForResidue.bit[m % 30]
+          });
+        }
+
+        ++active;
+      }
+
+      for (std::size_t j { 0 }; j * 8 < smallOffsets.size(); ++j) {
+        const std::uint32_t p   { m_basePrimes[j] };
+        std::uint32_t*      off { &smallOffsets[j * 8] };
+
+        for (int k { 0 }; k < 8; ++k) {
+          const std::uint8_t mask { wheelSteps.clear[p % 30][k] };
+          std::uint32_t o { off[k] };
+
+          for (; o < length; o += p)
+            seg[o] &= mask;
+
+          off[k] = o - static_cast<std::uint32_t>(length);
+        }
+      }
+
+      for (LargePrime& lp : large) {
+        const std::uint32_t q  { lp.prime / 30 };
+        const std::uint32_t pr { lp.prime % 30 };
+
+        while (lp.offset < length) {
+          seg[lp.offset] &= wheelSteps.clear[pr][lp.wheel];
+          lp.offset += q * wheelSteps.gap[lp.wheel] + wheelSteps.carry[pr][lp.wheel];
+          lp.wheel   = (lp.wheel + 1) & 7;
+        }
+
+        lp.offset -= static_cast<std::uint32_t>(length);
+      }
+
+      // The pattern clears the presieve primes themselves and keeps 1
+      if (segStart == 0)
+        seg[0] = static_cast<std::uint8_t>((seg[0] & ~1u) | 0b0001'1110); // 1 out; 7, 11, 13, 17 in
+
+      // Trim bits below lo and at or above hi
+      if (segStart == firstByte) {
+        for (int k { 0 }; k < 8; ++k) {
+          if (segLo + wheelResidues[k] < lo)
+            seg[0] &= static_cast<std::uint8_t>(~(1u << k));
+        }
+      }
+
+      if (segStart + length == endByte) {
+        const std::uint64_t lastBase { (endByte - 1) * 30 };
+
+        for (int k { 0 }; k < 8; ++k) {
+          if (lastBase + wheelResidues[k] >= hi)
+            seg[length - 1] &= static_cast<std::uint8_t>(~(1u << k));
+        }
+      }
+
+      if (visit)
+        visit(Segment { segLo, seg, length });
+    }
+  }
+
+  std::vector<std::uint64_t> SegmentedSieve::primesInRange(std::uint64_t lo, std::uint64_t hi) const {
+    std::vector<std::uint64_t> primes { };
+    forEachPrime(lo, hi, [&](std::uint64_t p) { primes.push_back(p); });
+
+    return primes;
+  }
+
+  std::uint64_t SegmentedSieve::countPrimes(std::uint64_t lo, std::uint64_t hi) const {
+    std::uint64_t count { 0 };
+
+    for (std::uint64_t p : { 2u, 3u, 5u }) {
+      if (p >= lo && p < std::min(hi, m_limit))
+        ++count;
+    }
+
+    forEachSegment(lo, hi, [&](const Segment& seg) {
+      std::size_t i { 0 };
+
+      for (; i + 8 <= seg.bytes; i += 8) {
+        std::uint64_t word { };
+        std::memcpy(&word, seg.bits + i, 8);
+        count += static_cast<std::uint64_t>(__builtin_popcountll(word));
+      }
+
+      for (; i < seg.bytes; ++i)
+        count += static_cast<std::uint64_t>(__builtin_popcount(seg.bits[i]));
+    });
+
+    return count;
+  }
+
+  bool SegmentedSieve::isPrime(std::uint64_t n) const {
+    if (n < 7)
+      return n == 2 || n == 3 || n == 5;
+
+    if (n % 2 == 0 || n % 3 == 0 || n % 5 == 0)
+      return false;
+
+    if (n >= m_limit)
+      return isPrime64(n);
+
+    // 7..17 are not among the base primes (the presieve pattern covers them)
+    if (n <= presievePrimes[std::size(presievePrimes) - 1])
+      return std::find(std::begin(presievePrimes), std::end(presievePrimes), n) != std::end(presievePrimes);
+
+    if (!m_basePrimes.empty() && n <= m_basePrimes.back())
+      return std::binary_search(m_basePrimes.begin(), m_basePrimes.end(), n);
+
+    bool prime { false };
+    forEachSegment(n, n + 1, [&](const Segment& seg) { prime = (seg.bits[0] != 0); });
+
+    return prime;
+  }
+}
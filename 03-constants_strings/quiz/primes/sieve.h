@@ -0,0 +1,96 @@
+// +--------------------------------------------+
+// |        SEGMENTED WHEEL SIEVE (MOD 30)      |
+// +--------------------------------------------+
+//
+// Sieve of Eratosthenes that walks [lo, hi) one L1-sized segment at a time.
+// Every byte of a segment stands for 30 consecutive numbers, and its 8 bits
+// are the residues coprime to 30: 1, 7, 11, 13, 17, 19, 23, 29.
+// Multiples of 2, 3 and 5 are never stored, so 30 numbers fit in one byte.
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+namespace Primes {
+  // Residue represented by each bit of a wheel byte
+  inline constexpr std::uint8_t wheelResidues[8] { 1, 7, 11, 13, 17, 19, 23, 29 };
+
+  // Bytes per segment, sized to fit in a 32 KiB L1 data cache
+  inline constexpr std::size_t segmentBytes { 32 * 1024 };
+
+  // -- One sieved segment --
+  // bits[i] covers the numbers base + 30 * i + wheelResidues[bit].
+  // Bits outside the requested [lo, hi) are already cleared.
+  struct Segment {
+    std::uint64_t       base  { };
+    const std::uint8_t* bits  { };
+    std::size_t         bytes { };
+  };
+
+  class SegmentedSieve {
+  public:
+    // Prepares base primes up to sqrt(limit); queries must stay below limit
+    explicit SegmentedSieve(std::uint64_t limit);
+
+    std::uint64_t limit() const { return m_limit; }
+
+    // Calls visit once per segment, in increasing order.
+    // 2, 3 and 5 are not part of the wheel and are never reported here.
+    void forEachSegment(std::uint64_t lo, std::uint64_t hi,
+                        const std::function<void(const Segment&)>& visit) const;
+
+    // Same sieve, written in place into a bitmap of the whole range: byte i
+    // covers 30 * i + wheelResidues[bit], and only the bytes that overlap
+    // [lo, hi) are written (bits outside it cleared), with no segment buffer
+    void sieveInto(std::uint64_t lo, std::uint64_t hi, std::uint8_t* bitmap) const;
+
+    // Calls f(p) for every prime p in [lo, min(hi, limit)), in increasing order
+    template <typename F>
+    void forEachPrime(std::uint64_t lo, std::uint64_t hi, F&& f) const;
+
+    std::vector<std::uint64_t> primesInRange(std::uint64_t lo, std::uint64_t hi) const;
+    std::uint64_t countPrimes(std::uint64_t lo, std::uint64_t hi) const;
+
+    // Numbers up to sqrt(limit) are looked up among the base primes, and
+    // numbers at or past limit go to isPrime64 (link miller_rabin.cpp).
+    // Anything in between sieves a one-byte segment, which still walks
+    // every base prime up to sqrt(n): for many lookups, sieve the range
+    // once with forEachSegment or use a PrimeCache.
+    bool isPrime(std::uint64_t n) const;
+
+  private:
+    // bitmap: sieve in place there instead of a segment buffer; visit may
+    // be empty
+    void sieve(std::uint64_t lo, std::uint64_t hi, std::uint8_t* bitmap,
+               const std::function<void(const Segment&)>& visit) const;
+
+    std::uint64_t              m_limit      { };
+    std::vector<std::uint32_t> m_basePrimes { }; // primes 7 .. sqrt(limit)
+  };
+
+  template <typename F>
+  void SegmentedSieve::forEachPrime(std::uint64_t lo, std::uint64_t hi, F&& f) const {
+    hi = std::min(hi, m_limit);
+
+    for (std::uint64_t p : { 2u, 3u, 5u }) {
+      if (p >= lo && p < hi)
+        f(p);
+    }
+
+    forEachSegment(lo, hi, [&](const Segment& seg) {
+      for (std::size_t i { 0 }; i < seg.bytes; ++i) {
+        unsigned byte { seg.bits[i] };
+
+        while (byte) {
+          int bit { __builtin_ctz(byte) };
+          f(seg.base + 30 * i + wheelResidues[bit]);
+          byte &= byte - 1;
+        }
+      }
+    });
+  }
+}
@@ -1,40 +1,85 @@
-#include <iostream>
+// g++ -std=c++20 -O2 yes.cpp ../../common/batch.cpp ../../common/utf8.cpp ../../common/fast_io.cpp ../../common/int_format.cpp ../../common/int_parse.cpp ../../common/float_parse.cpp -o yes
+// ./yes                 asks for two people
+// ./yes people.txt      batch: "name<TAB>age<TAB>name<TAB>age" per line
+
+#include "../../common/batch.h"
+#include "../../common/console.h"
+#include "../../common/utf8.h"
+#include <algorithm>
 #include <string>
+#include <string_view>
 
 std::string askName() {
   std::string name { };
 
-  std::cout    << "What's your name lil bro?: ";
-  std::getline  ( std::cin >> std::ws, name );
+  while (true) {
+    Console::out << "What's your name lil bro?: ";
+
+    // The name is echoed back later, so mangled bytes are asked for again
+    if (!Console::readLine(name) || Utf8::validate(name))
+      return name;
 
-  return name;
+    Console::out << "That name isn't valid UTF-8, try again\n";
+  }
 }
 
 int askAge () {
   unsigned int age { };
 
-  std::cout << "How old are you lil bro?: ";
-  std::cin  >> age;
+  Console::out << "How old are you lil bro?: ";
+  Console::in  >> age;
 
   return age;
 }
 
-int main() {
-  std::string name1 { askName() };
-  int age1 { askAge() };
-
-  std::string name2 { askName() };
-  int age2 { askAge() };
-
+// Shared by the prompts and the batch driver
+template <typename Out>
+void compareAges(Out& out, std::string_view name1, int age1, std::string_view name2, int age2) {
   if (age1 > age2) {
-    std::cout << name1 << " is older than " << name2 << "\n";
+    out << name1 << " is older than " << name2 << "\n";
   }
 
   else if (age2 > age1) {
-    std::cout << name2 << " is older than " << name1 << "\n";
+    out << name2 << " is older than " << name1 << "\n";
   }
 
   else {
-    std::cout << "They're equal blud";
+    out << "They're equal blud\n";
   }
 }
+
+// Exactly four fields; an empty or extra field, or an age that is negative
+// or does not fit in an int, makes the record malformed
+bool compareRecord(std::string_view record, FastIO::Writer& out) {
+  if (std::count(record.begin(), record.end(), '\t') != 3)
+    return false;
+
+  const std::string_view name1 { Batch::nextField(record, true) };
+  const std::string_view age1  { Batch::nextField(record, true) };
+  const std::string_view name2 { Batch::nextField(record, true) };
+  const std::string_view age2  { Batch::nextField(record, true) };
+
+  int years1 { }, years2 { };
+
+  if (name1.empty() || name2.empty() || !Batch::parseField(age1, years1) || !Batch::parseField(age2, years2))
+    return false;
+
+  if (years1 < 0 || years2 < 0)
+    return false;
+
+  compareAges(out, name1, years1, name2, years2);
+  return true;
+}
+
+int main(int argc, char** argv) {
+  if (argc > 1)
+    return Batch::main(argv[1], compareRecord);
+
+  std::string name1 { askName() };
+  int age1 { askAge() };
+
+  std::string name2 { askName() };
+  int age2 { askAge() };
+
+  compareAges(Console::out, name1, age1, name2, age2);
+}
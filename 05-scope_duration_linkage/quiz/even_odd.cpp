@@ -1,21 +1,91 @@
-#include <iostream>
+// g++ -std=c++20 -O2 -pthread even_odd.cpp partition/partition.cpp ../../common/fast_io.cpp ../../common/int_format.cpp ../../common/int_parse.cpp ../../common/float_parse.cpp -o even_odd
+// ./even_odd                 asks for one integer
+// ./even_odd numbers.txt     splits every integer of the file: evens, then odds, in input order
+
+#include "partition/partition.h"
+#include "../../common/console.h"
+#include "../../common/fast_io.h"
+#include "../../common/int_parse.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <string_view>
+#include <vector>
+
+#include <fcntl.h>
+#include <unistd.h>
 
 bool isEven(int value) {
   return (value % 2 == 0);
 }
 
-int main() {
+// Every integer of the file, split on all cores
+int splitFile(const char* path) {
+  const int fd { open(path, O_RDONLY) };
+
+  if (fd < 0) {
+    std::perror(path);
+    return 1;
+  }
+
+  std::vector<std::int32_t> values { };
+
+  {
+    FastIO::Reader in { fd };
+
+    // End of input ends the loop; a token that is not an int32 ends the run
+    while (in.skipWhitespace()) {
+      const std::uint64_t    offset { in.offset() };
+      const std::string_view token  { in.token() };
+      std::int32_t           value  { };
+      const IntParse::Result result { IntParse::parseField(token, value) };
+
+      if (!result) {
+        std::fprintf(stderr, "%s: byte %llu: \"%.*s\": %s\n", path, static_cast<unsigned long long>(offset),
+                     static_cast<int>(token.size()), token.data(), IntParse::describe(result.error));
+        close(fd);
+        return 1;
+      }
+
+      values.push_back(value);
+    }
+  }
+
+  close(fd);
+
+  std::vector<std::int32_t> evens { }, odds { };
+  const Partition::Counts counts { Partition::partitionCopy(values, evens, odds, Partition::Even { }, 0) };
+
+  FastIO::Writer out { 1 };
+  out << counts.matching << " even, " << counts.rest << " odd\n";
+
+  for (const std::int32_t value : evens)
+    out << value << ' ';
+  out << '\n';
+
+  for (const std::int32_t value : odds)
+    out << value << ' ';
+  out << '\n';
+
+  out.flush();
+  return 0;
+}
+
+int main(int argc, char** argv) {
+  if (argc > 1)
+    return splitFile(argv[1]);
+
   int value { };
   
-  std::cout << "Enter an integer: ";
-  std::cin  >> value;
+  Console::out << "Enter an integer: ";
+  Console::in  >> value;
 
   if ( isEven (value) ) {
-    std::cout << value << " is even" << "\n";
+    Console::out << value << " is even" << "\n";
   }
 
   else {
-    std::cout << value << " is odd" << "\n";
+    Console::out << value << " is odd" << "\n";
   }
 
 }
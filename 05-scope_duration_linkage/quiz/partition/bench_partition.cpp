@@ -0,0 +1,101 @@
+// +--------------------------------------------+
+// |         EVEN / ODD PARTITION THROUGHPUT    |
+// +--------------------------------------------+
+//
+// g++ -std=c++20 -O2 -pthread partition.cpp bench_partition.cpp -o bench_partition
+// ./bench_partition [millions] [threads]   (defaults: 64 million values, every hardware thread)
+//
+// Random int32 values are split into evens and odds by std::partition_copy
+// (one isEven call per value, as even_odd does) and by Partition with 1,
+// 2, 4, ... threads. Besides the half-and-half case, a skewed input (1 in
+// 64 odd) and a predicate without a vector form (multiple of 3) are timed.
+
+#include "partition.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+  template <typename F>
+  double bestSeconds(F&& f) {
+    double best { 1e30 };
+
+    for (int rep { 0 }; rep < 3; ++rep) {
+      auto start { std::chrono::steady_clock::now() };
+      f();
+      best = std::min(best, std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+    }
+
+    return best;
+  }
+
+  bool isEven(int value) {
+    return (value % 2 == 0);
+  }
+
+  // No lanes(): the engine tests 8 values one at a time, then compacts them
+  struct MultipleOf3 {
+    bool operator()(std::int32_t x) const { return x % 3 == 0; }
+  };
+
+  void report(const std::string& method, std::size_t values, double seconds, bool same) {
+    std::cout << "  " << method << values / seconds / 1e6 << " M values/s  ("
+              << values * sizeof(std::int32_t) / seconds / 1e9 << " GB/s in)" << (same ? "\n" : "  [MISMATCH]\n");
+  }
+
+  template <typename Predicate>
+  void bench(const char* name, const std::vector<std::int32_t>& values, const Predicate& predicate, unsigned threads) {
+    std::cout << name << '\n';
+
+    std::vector<std::int32_t> matching(values.size()), rest(values.size());
+    std::vector<std::int32_t> expectMatching(values.size()), expectRest(values.size());
+    std::size_t expected { };
+
+    const double standard { bestSeconds([&] {
+      expected = static_cast<std::size_t>(std::partition_copy(values.begin(), values.end(), expectMatching.begin(), expectRest.begin(),
+                                                              predicate).first - expectMatching.begin());
+    }) };
+    report("std::partition_copy:    ", values.size(), standard, true);
+
+    for (unsigned t { 1 }; t <= threads; t *= 2) {
+      Partition::Counts counts { };
+      const double engine { bestSeconds([&] { counts = Partition::partitionCopy(values, matching.data(), rest.data(), predicate, t); }) };
+
+      const bool same { counts.matching == expected
+                        && std::equal(matching.begin(), matching.begin() + static_cast<std::ptrdiff_t>(expected), expectMatching.begin())
+                        && std::equal(rest.begin(), rest.begin() + static_cast<std::ptrdiff_t>(counts.rest), expectRest.begin()) };
+
+      report("Partition, " + std::to_string(t) + (t == 1 ? " thread:    " : " threads:   "), values.size(), engine, same);
+    }
+  }
+}
+
+int main(int argc, char** argv) {
+  const std::size_t millions { argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 64ull };
+  unsigned          threads  { argc > 2 ? static_cast<unsigned>(std::strtoul(argv[2], nullptr, 10)) : 0u };
+
+  if (threads == 0)
+    threads = std::max(1u, std::thread::hardware_concurrency());
+
+  std::mt19937 rng { 7 };
+  std::vector<std::int32_t> random(millions * 1'000'000);
+  for (auto& v : random)
+    v = static_cast<std::int32_t>(rng());
+
+  std::vector<std::int32_t> skewed(random.size());
+  for (auto& v : skewed)
+    v = static_cast<std::int32_t>(rng() % 64 == 0 ? rng() | 1 : rng() & ~1u);
+
+  bench("random, even/odd (isEven)",     random, [](std::int32_t v) { return isEven(v); }, threads);
+  bench("random, even/odd (Even)",       random, Partition::Even { }, threads);
+  bench("skewed, 1 in 64 odd (Even)",    skewed, Partition::Even { }, threads);
+  bench("random, multiple of 3 (scalar)", random, MultipleOf3 { }, threads);
+
+  return 0;
+}
@@ -0,0 +1,38 @@
+#include "partition.h"
+
+#include <algorithm>
+#include <thread>
+
+namespace Partition::detail {
+  bool hasAvx2() {
+#ifdef PARTITION_X86
+    static const bool avx2 { static_cast<bool>(__builtin_cpu_supports("avx2")) };
+    return avx2;
+#else
+    return false;
+#endif
+  }
+
+  void parallelFor(unsigned chunks, const std::function<void(unsigned)>& body) {
+    std::vector<std::thread> workers { };
+
+    for (unsigned t { 1 }; t < chunks; ++t)
+      workers.emplace_back(body, t);
+
+    // The calling thread takes the first chunk itself
+    body(0);
+
+    for (std::thread& worker : workers)
+      worker.join();
+  }
+
+  unsigned threadsFor(std::size_t values, unsigned threads) {
+    if (threads == 0)
+      threads = std::max(1u, std::thread::hardware_concurrency());
+
+    // A chunk below this is done before a thread would have started
+    constexpr std::size_t minChunk { 1 << 16 };
+
+    return static_cast<unsigned>(std::clamp<std::size_t>(values / minChunk, 1, threads));
+  }
+}
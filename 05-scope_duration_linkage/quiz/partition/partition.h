@@ -0,0 +1,288 @@
+// +--------------------------------------------+
+// |       STABLE PARTITION (STREAM COMPACTION) |
+// +--------------------------------------------+
+//
+// even_odd classifies one integer. This splits a whole int32 array by a
+// predicate (parity, or any other bit test) into two outputs, keeping the
+// input order on both sides, like std::partition_copy:
+//
+//   Partition::Counts c { Partition::partitionCopy(values, evens, odds, Partition::Even { }) };
+//
+// With AVX2, 8 values are tested at once and the predicate's lane mask
+// becomes an 8-bit number m. compressIndices[m] is the permutation that
+// moves the matching lanes to the front in order; one vpermd applies it
+// and the whole vector is stored at the matching output, which then only
+// advances by popcount(m). The same table at ~m sends the other lanes to
+// the second output. No branch depends on the data.
+//
+// Threads split the input into contiguous chunks in two passes: each one
+// counts its matches, an exclusive prefix sum over the counts gives every
+// chunk its exact place in both outputs, and then each chunk is
+// partitioned straight into place. A store that would spill past a
+// chunk's region (into a neighbour's) goes through a small buffer instead.
+//
+// A predicate is any type with bool operator()(std::int32_t) const. If it
+// also has `__m256i lanes(__m256i) const` (all-ones where the lane
+// matches, compiled for AVX2), the test is vectorized too; otherwise the
+// 8 lanes are tested one by one and only the compaction is vectorized.
+
+#pragma once
+
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <span>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+  #include <immintrin.h>
+  #define PARTITION_X86 1
+#endif
+
+namespace Partition {
+  struct Counts {
+    std::size_t matching { 0 };
+    std::size_t rest     { 0 };
+  };
+
+  // (x & mask) == value: even is { 1, 0 }, a multiple of 8 is { 7, 0 }
+  struct BitsEqual {
+    std::int32_t mask  { 1 };
+    std::int32_t value { 0 };
+
+    bool operator()(std::int32_t x) const { return (x & mask) == value; }
+
+#ifdef PARTITION_X86
+    __attribute__((target("avx2")))
+    __m256i lanes(__m256i x) const {
+      return _mm256_cmpeq_epi32(_mm256_and_si256(x, _mm256_set1_epi32(mask)), _mm256_set1_epi32(value));
+    }
+#endif
+  };
+
+  struct Even : BitsEqual {
+    Even() : BitsEqual { 1, 0 } { }
+  };
+
+  struct Odd : BitsEqual {
+    Odd() : BitsEqual { 1, 1 } { }
+  };
+
+  namespace detail {
+    // Byte i of entry m: the lane that goes to position i, set lanes of m
+    // first (in order), then the others
+    constexpr std::array<std::uint64_t, 256> makeCompressIndices() {
+      std::array<std::uint64_t, 256> table { };
+
+      for (unsigned m { 0 }; m < 256; ++m) {
+        std::uint64_t entry { 0 };
+        int at { 0 };
+
+        for (int pass { 0 }; pass < 2; ++pass)
+          for (unsigned lane { 0 }; lane < 8; ++lane)
+            if (((m >> lane) & 1) == (pass == 0 ? 1u : 0u))
+              entry |= std::uint64_t { lane } << (8 * at++);
+
+        table[m] = entry;
+      }
+
+      return table;
+    }
+
+    inline constexpr std::array<std::uint64_t, 256> compressIndices { makeCompressIndices() };
+
+    bool hasAvx2();
+
+    // Runs body(0) .. body(chunks - 1), one thread each
+    void parallelFor(unsigned chunks, const std::function<void(unsigned)>& body);
+
+    unsigned threadsFor(std::size_t values, unsigned threads);
+
+    template <typename Predicate>
+    std::size_t countScalar(const std::int32_t* in, std::size_t n, const Predicate& predicate) {
+      std::size_t count { 0 };
+
+      for (std::size_t i { 0 }; i < n; ++i)
+        count += predicate(in[i]);
+
+      return count;
+    }
+
+    // Plain branchy loop: where the vector path ends, and without AVX2
+    template <typename Predicate>
+    void partitionScalar(const std::int32_t* in, std::size_t n, std::int32_t* matching, std::int32_t* rest,
+                         const Predicate& predicate, Counts& done) {
+      for (std::size_t i { 0 }; i < n; ++i) {
+        if (predicate(in[i]))
+          matching[done.matching++] = in[i];
+        else
+          rest[done.rest++] = in[i];
+      }
+    }
+
+#ifdef PARTITION_X86
+    template <typename Predicate>
+    concept VectorPredicate = requires(const Predicate& predicate, __m256i v) {
+      predicate.lanes(v);
+    };
+
+    template <typename Predicate>
+    __attribute__((target("avx2")))
+    unsigned laneMask(const Predicate& predicate, const std::int32_t* in, __m256i v) {
+      if constexpr (VectorPredicate<Predicate>) {
+        return static_cast<unsigned>(_mm256_movemask_ps(_mm256_castsi256_ps(predicate.lanes(v))));
+      }
+
+      else {
+        unsigned mask { 0 };
+
+        for (unsigned lane { 0 }; lane < 8; ++lane)
+          mask |= static_cast<unsigned>(predicate(in[lane])) << lane;
+
+        return mask;
+      }
+    }
+
+    template <typename Predicate>
+    __attribute__((target("avx2")))
+    std::size_t countAvx2(const std::int32_t* in, std::size_t n, const Predicate& predicate) {
+      std::size_t count { 0 }, i { 0 };
+
+      for (; i + 8 <= n; i += 8) {
+        const __m256i v { _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i)) };
+        count += static_cast<std::size_t>(std::popcount(laneMask(predicate, in + i, v)));
+      }
+
+      return count + countScalar(in + i, n - i, predicate);
+    }
+
+    // Stores the first `count` lanes of v at out + at; all 8 when there is
+    // room, so the store needs no length
+    __attribute__((target("avx2")))
+    inline void storeFront(std::int32_t* out, std::size_t at, std::size_t room, __m256i v, std::size_t count) {
+      if (room - at >= 8) {
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + at), v);
+        return;
+      }
+
+      alignas(32) std::int32_t lanes[8];
+      _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), v);
+      std::memcpy(out + at, lanes, count * sizeof(std::int32_t));
+    }
+
+    template <typename Predicate>
+    __attribute__((target("avx2")))
+    void partitionAvx2(const std::int32_t* in, std::size_t n, std::int32_t* matching, std::size_t matchingRoom,
+                       std::int32_t* rest, std::size_t restRoom, const Predicate& predicate, Counts& done) {
+      std::size_t i { 0 };
+
+      for (; i + 8 <= n; i += 8) {
+        const __m256i  v    { _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i)) };
+        const unsigned mask { laneMask(predicate, in + i, v) };
+        const auto     hits { static_cast<std::size_t>(std::popcount(mask)) };
+
+        const __m256i toMatching { _mm256_permutevar8x32_epi32(v, _mm256_cvtepu8_epi32(_mm_loadl_epi64(
+                                     reinterpret_cast<const __m128i*>(&compressIndices[mask])))) };
+        const __m256i toRest     { _mm256_permutevar8x32_epi32(v, _mm256_cvtepu8_epi32(_mm_loadl_epi64(
+                                     reinterpret_cast<const __m128i*>(&compressIndices[~mask & 0xFF])))) };
+
+        storeFront(matching, done.matching, matchingRoom, toMatching, hits);
+        storeFront(rest,     done.rest,     restRoom,     toRest,     8 - hits);
+
+        done.matching += hits;
+        done.rest     += 8 - hits;
+      }
+
+      partitionScalar(in + i, n - i, matching, rest, predicate, done);
+    }
+#endif
+
+    template <typename Predicate>
+    std::size_t countChunk(const std::int32_t* in, std::size_t n, const Predicate& predicate) {
+#ifdef PARTITION_X86
+      if (hasAvx2())
+        return countAvx2(in, n, predicate);
+#endif
+
+      return countScalar(in, n, predicate);
+    }
+
+    // Partitions into exactly matchingRoom and restRoom slots
+    template <typename Predicate>
+    Counts partitionChunk(const std::int32_t* in, std::size_t n, std::int32_t* matching, std::size_t matchingRoom,
+                          std::int32_t* rest, std::size_t restRoom, const Predicate& predicate) {
+      Counts done { };
+
+#ifdef PARTITION_X86
+      if (hasAvx2()) {
+        partitionAvx2(in, n, matching, matchingRoom, rest, restRoom, predicate, done);
+        return done;
+      }
+#else
+      static_cast<void>(matchingRoom);
+      static_cast<void>(restRoom);
+#endif
+
+      partitionScalar(in, n, matching, rest, predicate, done);
+      return done;
+    }
+  }
+
+  // Values matching `predicate` to `matching`, the others to `rest`, both
+  // in input order. Each output needs room for in.size() values. threads:
+  // 0 for every hardware thread.
+  template <typename Predicate>
+  Counts partitionCopy(std::span<const std::int32_t> in, std::int32_t* matching, std::int32_t* rest,
+                       const Predicate& predicate, unsigned threads = 1) {
+    threads = detail::threadsFor(in.size(), threads);
+
+    if (threads == 1)
+      return detail::partitionChunk(in.data(), in.size(), matching, in.size(), rest, in.size(), predicate);
+
+    const std::size_t perChunk { (in.size() + threads - 1) / threads };
+    auto chunkOf { [&](unsigned t) {
+      const std::size_t begin { std::min(in.size(), t * perChunk) };
+      return in.subspan(begin, std::min(in.size(), begin + perChunk) - begin);
+    } };
+
+    // Pass 1: how many of each chunk match
+    std::vector<std::size_t> hits(threads);
+    detail::parallelFor(threads, [&](unsigned t) {
+      const std::span<const std::int32_t> chunk { chunkOf(t) };
+      hits[t] = detail::countChunk(chunk.data(), chunk.size(), predicate);
+    });
+
+    // Exclusive prefix sums: where each chunk starts in both outputs
+    std::vector<Counts> start(threads + 1);
+    for (unsigned t { 0 }; t < threads; ++t) {
+      start[t + 1].matching = start[t].matching + hits[t];
+      start[t + 1].rest     = start[t].rest + chunkOf(t).size() - hits[t];
+    }
+
+    // Pass 2: every chunk straight into its place
+    detail::parallelFor(threads, [&](unsigned t) {
+      const std::span<const std::int32_t> chunk { chunkOf(t) };
+      detail::partitionChunk(chunk.data(), chunk.size(),
+                             matching + start[t].matching, hits[t],
+                             rest + start[t].rest, chunk.size() - hits[t], predicate);
+    });
+
+    return start[threads];
+  }
+
+  template <typename Predicate>
+  Counts partitionCopy(std::span<const std::int32_t> in, std::vector<std::int32_t>& matching, std::vector<std::int32_t>& rest,
+                       const Predicate& predicate, unsigned threads = 1) {
+    matching.resize(in.size());
+    rest.resize(in.size());
+
+    const Counts counts { partitionCopy(in, matching.data(), rest.data(), predicate, threads) };
+    matching.resize(counts.matching);
+    rest.resize(counts.rest);
+
+    return counts;
+  }
+}
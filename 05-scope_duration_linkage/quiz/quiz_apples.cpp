@@ -1,55 +1,78 @@
-#include <iostream>
+// g++ -std=c++20 -O2 quiz_apples.cpp ../../common/batch.cpp ../../common/utf8.cpp ../../common/fast_io.cpp ../../common/int_format.cpp ../../common/int_parse.cpp ../../common/float_parse.cpp -o quiz_apples
+// ./quiz_apples              asks how many apples you have
+// ./quiz_apples counts.txt   batch: one apple count per line
+
+#include "../../common/batch.h"
+#include "../../common/compiled_format.h"
+#include "../../common/console.h"
+#include "../../common/range_table.h"
+#include <string>
+#include <string_view>
 
 // Write the function getQuantityPhrase() here
+constexpr RangeTable::Rule<std::string_view> quantityRules[] {
+  { 0, 0,                     "no"          },
+  { 1, 1,                     "a single"    },
+  { 2, 2,                     "a couple of" },
+  { 3, 3,                     "a few"       },
+  { 4, RangeTable::unbounded, "many"        },
+};
+
+constexpr auto quantityPhrases { RangeTable::make<RangeTable::denseSize(quantityRules)>(quantityRules) };
+
 std::string_view getQuantityPhrase(unsigned int numApples) {
-  if (numApples < 0) {
-    return "negative";
-  }
-  
-  else if (numApples == 0) {
-    return "no";
-  }
-
-  else if (numApples == 1) {
-    return "a single";
-  }
-
-  else if (numApples == 2) {
-    return "a couple of";
-  }
-
-  else if (numApples == 3) {
-    return "a few";
-  }
-
-  else if (numApples > 3) {
-    return "many";
-  }
-
-  else {
-    return "sybau";
-  }
+  return quantityPhrases[numApples];
 }
 
 // Write the function getApplesPluralized() here
+constexpr RangeTable::Rule<std::string_view> pluralRules[] {
+  { 1, 1,                     "apple"  },
+  { 2, RangeTable::unbounded, "apples" },
+};
+
+constexpr auto applesPluralized { RangeTable::make<RangeTable::denseSize(pluralRules)>(pluralRules, "apples") };
+
 std::string_view getApplesPluralized(int maryApples) {
-  if (maryApples == 1) {
-    return "apple";
-  } 
+  // Negative counts land past the end, on "apples"
+  return applesPluralized[static_cast<unsigned int>(maryApples)];
+}
+
+// Shared by the prompt and the batch driver. The sentence is assembled in
+// one reused buffer and handed to `out` in one piece.
+template <typename Out>
+void describeApples(Out& out, std::string_view who, int numApples)
+{
+    static std::string sentence { };
+    sentence.clear();
 
-  return "apples";
-} 
+    CompiledFormat::appendTo<"{} {} {}.\n">(sentence, who, getQuantityPhrase(numApples), getApplesPluralized(numApples));
+    out << std::string_view { sentence };
+}
+
+bool describeRecord(std::string_view record, FastIO::Writer& out)
+{
+    int numApples{};
 
-int main()
+    if (!Batch::parseField(Batch::nextField(record), numApples))
+        return false;
+
+    describeApples(out, "You have", numApples);
+    return true;
+}
+
+int main(int argc, char** argv)
 {
+    if (argc > 1)
+        return Batch::main(argv[1], describeRecord);
+
     constexpr int maryApples { 3 };
-    std::cout << "Mary has " << getQuantityPhrase(maryApples) << ' ' << getApplesPluralized(maryApples) << ".\n";
+    describeApples(Console::out, "Mary has", maryApples);
 
-    std::cout << "How many apples do you have? ";
+    Console::out << "How many apples do you have? ";
     int numApples{};
-    std::cin >> numApples;
+    Console::in >> numApples;
 
-    std::cout << "You have " << getQuantityPhrase(numApples) << ' ' << getApplesPluralized(numApples) << ".\n";
+    describeApples(Console::out, "You have", numApples);
 
     return 0;
 }
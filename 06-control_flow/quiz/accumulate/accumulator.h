@@ -0,0 +1,84 @@
+// +--------------------------------------------+
+// |        SHARDED LOCK-FREE ACCUMULATOR       |
+// +--------------------------------------------+
+//
+// accumulate() kept its running total in a static int: two threads adding
+// at once lose updates. One std::atomic fixes that but does not scale,
+// because every add from every core fights over the same cache line.
+//
+// Here each thread adds into its own shard:
+//
+//   - Shards are padded to a cache line each, so threads on different
+//     shards never touch the same line (no false sharing).
+//   - A thread picks its shard once (a thread_local index handed out in
+//     order of first use); with more threads than shards, some share one,
+//     which is still correct because the add is atomic.
+//   - Adds are relaxed fetch_adds: nothing else is published through the
+//     total, so no ordering is needed, and an uncontended atomic add stays
+//     in the core's own cache.
+//   - total() sums the shards on demand, reading every shard's cache line,
+//     so calling it on every add contends like one atomic would. Adds
+//     running concurrently with it may or may not be counted; once they
+//     have all finished, it is exact. The sum is taken in the unsigned
+//     type, so a total past T's range wraps like the atomic adds do
+//     instead of being signed overflow.
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <memory>
+#include <thread>
+#include <type_traits>
+
+namespace Accumulate {
+  inline constexpr std::size_t cacheLine { 64 };
+
+  // Small, stable per-thread number: 0 for the first thread that asks, 1
+  // for the next, ...
+  inline std::size_t threadIndex() {
+    static std::atomic<std::size_t> next { 0 };
+    thread_local const std::size_t index { next.fetch_add(1, std::memory_order_relaxed) };
+
+    return index;
+  }
+
+  template <std::integral T>
+  class Sharded {
+  public:
+    // shards: rounded up to a power of two; 0 for one per hardware thread
+    explicit Sharded(std::size_t shards = 0)
+      : m_count { std::bit_ceil(std::max<std::size_t>(1, shards ? shards : std::thread::hardware_concurrency())) },
+        m_shards { std::make_unique<Shard[]>(m_count) } { }
+
+    Sharded(const Sharded&) = delete;
+    Sharded& operator=(const Sharded&) = delete;
+
+    void add(T value) {
+      m_shards[threadIndex() & (m_count - 1)].value.fetch_add(value, std::memory_order_relaxed);
+    }
+
+    T total() const {
+      using U = std::make_unsigned_t<T>;
+      U sum { 0 };
+
+      for (std::size_t i { 0 }; i < m_count; ++i)
+        sum += static_cast<U>(m_shards[i].value.load(std::memory_order_relaxed));
+
+      return static_cast<T>(sum);
+    }
+
+    std::size_t shards() const { return m_count; }
+
+  private:
+    struct alignas(cacheLine) Shard {
+      std::atomic<T> value { 0 };
+    };
+
+    std::size_t              m_count;
+    std::unique_ptr<Shard[]> m_shards;
+  };
+}
@@ -0,0 +1,101 @@
+// +--------------------------------------------+
+// |       CONCURRENT ACCUMULATOR THROUGHPUT    |
+// +--------------------------------------------+
+//
+// g++ -std=c++20 -O2 -pthread bench_accumulator.cpp -o bench_accumulator
+// ./bench_accumulator [millions] [threads]   (defaults: 16 million adds per thread, 2x the hardware threads)
+//
+// 1, 2, 4, ... threads each add 1..n into a shared total through:
+//
+//   - one std::atomic<long long> (relaxed fetch_add), every thread on one line
+//   - one long long behind a std::mutex
+//   - Accumulate::Sharded<long long>
+//   - Accumulate::Sharded<long long>, reading total() after every add (what
+//     accumulate() does to return the running total)
+//
+// and the final total is checked against the exact sum.
+
+#include "accumulator.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+  template <typename Add>
+  double runThreads(unsigned threads, std::size_t adds, Add add) {
+    std::vector<std::thread> workers { };
+    std::atomic<bool> go { false };
+
+    for (unsigned t { 0 }; t < threads; ++t) {
+      workers.emplace_back([&] {
+        while (!go.load(std::memory_order_acquire))
+          std::this_thread::yield();
+
+        for (std::size_t i { 1 }; i <= adds; ++i)
+          add(static_cast<long long>(i));
+      });
+    }
+
+    const auto start { std::chrono::steady_clock::now() };
+    go.store(true, std::memory_order_release);
+
+    for (std::thread& worker : workers)
+      worker.join();
+
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  }
+
+  void report(const char* method, std::size_t adds, double seconds, bool exact) {
+    std::cout << "  " << method << static_cast<double>(adds) / seconds / 1e6 << " M adds/s" << (exact ? "\n" : "  [WRONG TOTAL]\n");
+  }
+}
+
+int main(int argc, char** argv) {
+  const std::size_t millions   { argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 16ull };
+  unsigned          maxThreads { argc > 2 ? static_cast<unsigned>(std::strtoul(argv[2], nullptr, 10)) : 0u };
+
+  if (maxThreads == 0)
+    maxThreads = 2 * std::max(1u, std::thread::hardware_concurrency());
+
+  const std::size_t adds { millions * 1'000'000 };
+  const long long   perThread { static_cast<long long>(adds) * static_cast<long long>(adds + 1) / 2 };
+
+  for (unsigned threads { 1 }; threads <= maxThreads; threads *= 2) {
+    const long long expected { perThread * threads };
+    const std::size_t total  { adds * threads };
+    std::cout << threads << (threads == 1 ? " thread\n" : " threads\n");
+
+    std::atomic<long long> single { 0 };
+    const double atomic { runThreads(threads, adds, [&](long long v) { single.fetch_add(v, std::memory_order_relaxed); }) };
+    report("one std::atomic:       ", total, atomic, single.load() == expected);
+
+    std::mutex lock { };
+    long long guarded { 0 };
+    const double mutex { runThreads(threads, adds, [&](long long v) {
+      const std::lock_guard<std::mutex> hold { lock };
+      guarded += v;
+    }) };
+    report("std::mutex:            ", total, mutex, guarded == expected);
+
+    Accumulate::Sharded<long long> sharded { };
+    const double shards { runThreads(threads, adds, [&](long long v) { sharded.add(v); }) };
+    report("Accumulate::Sharded:   ", total, shards, sharded.total() == expected);
+
+    Accumulate::Sharded<long long> reread { };
+    std::atomic<long long> sink { 0 };
+    const double rereads { runThreads(threads, adds, [&](long long v) {
+      reread.add(v);
+      sink.store(reread.total(), std::memory_order_relaxed);
+    }) };
+    report("Sharded + total():     ", total, rereads, reread.total() == expected);
+  }
+
+  return 0;
+}
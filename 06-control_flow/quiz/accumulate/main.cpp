@@ -1,25 +1,31 @@
-#include <iostream>
+// g++ -std=c++20 -O2 main.cpp -o main
 
-int accumulate(int number) {
-  static bool alreadyran { false };
-  static int  total      { 0 };
+#include "accumulator.h"
+#include "../../../common/console.h"
 
-  if (!alreadyran) {
-    alreadyran = true;
-    total = number; 
-    return total;
-  } 
+namespace {
+  Accumulate::Sharded<int> total { };
+}
 
-  // total = total + number 
-  total += number;
-  return total;
+// Adds to the running total from any thread: one fetch_add on this
+// thread's shard, so it scales with the number of threads
+void addToTotal(int number) {
+  total.add(number);
+}
+
+// Adds and returns the running total. Reading the total touches every
+// shard, so this does not scale any better than one shared atomic; hot
+// loops should call addToTotal() and read the total once at the end
+int accumulate(int number) {
+  total.add(number);
+  return total.total();
 }
 
 int main() {
-    std::cout << accumulate(4) << '\n'; // prints 4
-    std::cout << accumulate(3) << '\n'; // prints 7
-    std::cout << accumulate(2) << '\n'; // prints 9
-    std::cout << accumulate(1) << '\n'; // prints 10
+    Console::out << accumulate(4) << '\n'; // prints 4
+    Console::out << accumulate(3) << '\n'; // prints 7
+    Console::out << accumulate(2) << '\n'; // prints 9
+    Console::out << accumulate(1) << '\n'; // prints 10
 
     return 0;
 }
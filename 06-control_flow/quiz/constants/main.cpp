@@ -1,18 +1,18 @@
 #include "constants.h"
-#include <iostream>
+#include "../../../common/console.h"
 
 int main() {
   int students{};
 
-	std::cout << "How many students are in your class? ";
-	std::cin  >> students;
+	Console::out << "How many students are in your class? ";
+	Console::in  >> students;
 
 	if (students > Constants::maxClassSize) {
-    std::cout << "There are too many students in this class";
+    Console::out << "There are too many students in this class";
   }
 
 	else { 
-    std::cout << "This class isn't too large";
+    Console::out << "This class isn't too large";
   }
 
 	return 0;
@@ -1,18 +1,18 @@
-#include <iostream>
+#include "../../../common/console.h"
 
 int main() {
   int num { };
 
-  std::cout << "Enter a positive number: ";
-  std::cin  >> num;
+  Console::out << "Enter a positive number: ";
+  Console::in  >> num;
 
   if (num < 0) {
-    std::cout << "[!] Negative number detected: " << '\n';
-    std::cout << "[+] Converted digit: " << -num << '\n';
+    Console::out << "[!] Negative number detected: " << '\n';
+    Console::out << "[+] Converted digit: " << -num << '\n';
   }
 
   else {
-    std::cout << "[+] You entered: " << num << '\n';
+    Console::out << "[+] You entered: " << num << '\n';
   }
 
   return 0;
@@ -1,10 +1,16 @@
-#include <iostream>
+// g++ -std=c++20 -O2 smaller_larger.cpp ../../../common/batch.cpp ../../../common/utf8.cpp ../../../common/fast_io.cpp ../../../common/int_format.cpp ../../../common/int_parse.cpp ../../../common/float_parse.cpp -o smaller_larger
+// ./smaller_larger               asks for two integers
+// ./smaller_larger pairs.txt     batch: "a b" per line
+
+#include "../../../common/batch.h"
+#include "../../../common/console.h"
+#include <string_view>
 
 int firstStage() {
   int value1 { };
 
-  std::cout << "Enter an integer: ";
-  std::cin  >> value1;
+  Console::out << "Enter an integer: ";
+  Console::in  >> value1;
 
   return value1;
 }
@@ -12,25 +18,44 @@ int firstStage() {
 int secondStage() { 
   int value2 { };
 
-  std::cout << "Enter a larger integer: ";
-  std::cin  >> value2;
+  Console::out << "Enter a larger integer: ";
+  Console::in  >> value2;
 
   return value2;
 }
 
-int main() {
-  int value1 { firstStage  () };
-  int value2 { secondStage () };
-
+// Shared by the prompts and the batch driver
+template <typename Out>
+void printOrdered(Out& out, int value1, int value2) {
   if (value1 > value2) {
-    std::cout << "The smaller number is: " << value2 << '\n';
-    std::cout << "The larger number is: "  << value1 << '\n';
+    out << "The smaller number is: " << value2 << '\n';
+    out << "The larger number is: "  << value1 << '\n';
   }
 
   else {
-    std::cout << "The smaller number is: " << value1 << '\n';
-    std::cout << "The larger number is: "  << value2 << '\n';
+    out << "The smaller number is: " << value1 << '\n';
+    out << "The larger number is: "  << value2 << '\n';
   }
+}
+
+bool orderRecord(std::string_view record, FastIO::Writer& out) {
+  int value1 { }, value2 { };
+
+  if (!Batch::parseField(Batch::nextField(record), value1) || !Batch::parseField(Batch::nextField(record), value2))
+    return false;
+
+  printOrdered(out, value1, value2);
+  return true;
+}
+
+int main(int argc, char** argv) {
+  if (argc > 1)
+    return Batch::main(argv[1], orderRecord);
+
+  int value1 { firstStage  () };
+  int value2 { secondStage () };
+
+  printOrdered(Console::out, value1, value2);
 
   return 0;
 }
@@ -0,0 +1,143 @@
+#include "batch.h"
+#include "utf8.h"
+
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace Batch {
+  namespace {
+    using Clock = std::chrono::steady_clock;
+
+    double percentile(std::vector<double>& samples, double fraction) {
+      if (samples.empty())
+        return 0.0;
+
+      const auto at { static_cast<std::size_t>(fraction * static_cast<double>(samples.size() - 1)) };
+      std::nth_element(samples.begin(), samples.begin() + static_cast<std::ptrdiff_t>(at), samples.end());
+
+      return samples[at];
+    }
+  }
+
+  bool run(const char* path, Handler handle, FastIO::Writer& out, Stats& stats) {
+    const bool useStdin { std::string_view { path } == "-" };
+    const int  fd       { useStdin ? 0 : open(path, O_RDONLY) };
+
+    if (fd < 0)
+      return false;
+
+    stats = Stats { };
+    std::vector<double> samples { };
+
+    {
+      FastIO::Reader in { fd };
+      const auto start { Clock::now() };
+
+      for (std::string_view chunk { in.lines() }; !chunk.empty(); chunk = in.lines()) {
+        // '\n' and '\r' never occur inside a multibyte sequence, so a valid
+        // chunk splits into valid records
+        const bool validChunk { Utf8::validate(chunk) };
+
+        while (!chunk.empty()) {
+          const std::size_t newline { chunk.find('\n') };
+          std::string_view record { chunk.substr(0, newline) };
+          chunk.remove_prefix(newline == std::string_view::npos ? chunk.size() : newline + 1);
+
+          if (!record.empty() && record.back() == '\r')
+            record.remove_suffix(1);
+
+          if (record.empty())
+            continue;
+
+          if (!validChunk && !Utf8::validate(record)) {
+            ++stats.records;
+            ++stats.malformed;
+            ++stats.invalidUtf8;
+            continue;
+          }
+
+          if (stats.records++ % sampleEvery == 0) {
+            const auto before { Clock::now() };
+            stats.malformed += !handle(record, out);
+            samples.push_back(std::chrono::duration<double, std::nano>(Clock::now() - before).count());
+          }
+
+          else {
+            stats.malformed += !handle(record, out);
+          }
+        }
+      }
+
+      out.flush();
+      stats.seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    }
+
+    if (!useStdin)
+      close(fd);
+
+    stats.p50  = percentile(samples, 0.50);
+    stats.p90  = percentile(samples, 0.90);
+    stats.p99  = percentile(samples, 0.99);
+    stats.p999 = percentile(samples, 0.999);
+    stats.max  = samples.empty() ? 0.0 : *std::max_element(samples.begin(), samples.end());
+
+    return true;
+  }
+
+  void printStats(const Stats& stats, FastIO::Writer& err) {
+    const double rate { stats.seconds > 0.0 ? static_cast<double>(stats.records) / stats.seconds : 0.0 };
+
+    err << stats.records << " records (" << stats.malformed << " malformed";
+
+    if (stats.invalidUtf8 > 0)
+      err << ", " << stats.invalidUtf8 << " not UTF-8";
+
+    err << ") in " << stats.seconds << " s, "
+        << rate / 1e6 << " M records/s\n"
+        << "latency ns  p50 " << stats.p50 << "  p90 " << stats.p90 << "  p99 " << stats.p99
+        << "  p99.9 " << stats.p999 << "  max " << stats.max
+        << "  (1 in " << sampleEvery << " sampled)\n";
+
+    err.flush();
+  }
+
+  int main(const char* path, Handler handle) {
+    FastIO::Writer out { 1 };
+    FastIO::Writer err { 2, 4096 };
+    Stats stats { };
+
+    if (!run(path, handle, out, stats)) {
+      err << "cannot open " << path << '\n';
+      return 1;
+    }
+
+    printStats(stats, err);
+    return stats.malformed == 0 ? 0 : 2;
+  }
+
+  std::string_view nextField(std::string_view& record, bool tabsOnly) {
+    // One tab per separator, so an empty field keeps its column instead of
+    // shifting the ones after it
+    if (tabsOnly) {
+      const std::size_t end { std::min(record.find('\t'), record.size()) };
+      const std::string_view field { record.substr(0, end) };
+      record.remove_prefix(std::min(end + 1, record.size()));
+
+      return field;
+    }
+
+    const std::string_view separators { " \t" };
+
+    const std::size_t begin { std::min(record.find_first_not_of(separators), record.size()) };
+    const std::size_t end   { std::min(record.find_first_of(separators, begin), record.size()) };
+
+    const std::string_view field { record.substr(begin, end - begin) };
+    record.remove_prefix(end);
+
+    return field;
+  }
+}
@@ -0,0 +1,67 @@
+// +--------------------------------------------+
+// |        NON-INTERACTIVE BATCH DRIVER        |
+// +--------------------------------------------+
+//
+// Runs a prompt-driven quiz program over a file of records instead of a
+// person at the keyboard: one record per line, read in 1 MiB chunks, one
+// result per record on stdout, no prompts.
+//
+//   ./yes people.txt       ./yes - < people.txt
+//
+// Records must be valid UTF-8. Each chunk is validated in one pass, and
+// records of a chunk that fails are checked one by one; invalid ones count
+// as malformed and never reach the handler.
+//
+// When the input is done, a summary goes to stderr: records/second and
+// per-record latency percentiles. Timing every record would cost more than
+// the work being timed, so one record in `sampleEvery` is timed.
+
+#pragma once
+
+#include "fast_io.h"
+
+#include <charconv>
+#include <concepts>
+#include <cstddef>
+#include <string_view>
+
+namespace Batch {
+  // Handles one record (without its '\n'); false if it is malformed
+  using Handler = bool (*)(std::string_view record, FastIO::Writer& out);
+
+  inline constexpr std::size_t sampleEvery { 64 };
+
+  struct Stats {
+    std::size_t records     { 0 };
+    std::size_t malformed   { 0 };
+    std::size_t invalidUtf8 { 0 };   // of the malformed ones
+    double      seconds     { 0.0 };
+    double      p50         { 0.0 }; // nanoseconds per record
+    double      p90         { 0.0 };
+    double      p99         { 0.0 };
+    double      p999        { 0.0 };
+    double      max         { 0.0 };
+  };
+
+  // Streams every record of `path` ("-" for stdin) through `handle` into `out`.
+  // Returns false if the file cannot be opened.
+  bool run(const char* path, Handler handle, FastIO::Writer& out, Stats& stats);
+
+  void printStats(const Stats& stats, FastIO::Writer& err);
+
+  // The whole batch mode of a program: run on argv[1], results to stdout,
+  // summary to stderr. Returns the exit status.
+  int main(const char* path, Handler handle);
+
+  // Removes and returns the next field. With tabsOnly, every tab ends one
+  // field (fields may contain spaces, and two tabs in a row enclose an empty
+  // field); otherwise any run of tabs and spaces separates fields
+  std::string_view nextField(std::string_view& record, bool tabsOnly = false);
+
+  // The whole field must be a number
+  template <std::integral T>
+  bool parseField(std::string_view field, T& value) {
+    const auto [end, ec] { std::from_chars(field.data(), field.data() + field.size(), value) };
+    return !field.empty() && ec == std::errc { } && end == field.data() + field.size();
+  }
+}
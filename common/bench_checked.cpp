@@ -0,0 +1,108 @@
+// +--------------------------------------------+
+// |          COST OF OVERFLOW CHECKING         |
+// +--------------------------------------------+
+//
+// g++ -std=c++20 -O2 checked.cpp bench_checked.cpp -o bench_checked
+// ./bench_checked [elements]   (default: 16M)
+//
+// Wrap is the unchecked kernel; Saturate and Report pay for detection.
+// One overflow is planted near the end so Report has to find it.
+
+#include "checked.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <vector>
+
+namespace {
+  const char* opName(Checked::Op op) {
+    switch (op) {
+      case Checked::Op::add:      return "add     ";
+      case Checked::Op::subtract: return "subtract";
+      default:                    return "multiply";
+    }
+  }
+
+  template <typename Policy, typename T>
+  void run(const char* name, Checked::Op op, Checked::Kernel kernel, const std::vector<T>& a,
+           const std::vector<T>& b, std::vector<T>& out, std::size_t expected) {
+    std::size_t first { };
+    double best { 1e30 };
+
+    for (int rep { 0 }; rep < 5; ++rep) {
+      auto start { std::chrono::steady_clock::now() };
+      first = Checked::apply<Policy>(op, a.data(), b.data(), out.data(), a.size(), kernel);
+      best = std::min(best, std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+    }
+
+    const bool wrap { std::is_same_v<Policy, Checked::Wrap> };
+    const bool ok   { first == (wrap ? a.size() : expected) };
+
+    std::cout << "  " << name << ":\t" << a.size() / best / 1e6 << " M elements/s"
+              << (ok ? "" : "  [WRONG INDEX]") << '\n';
+  }
+
+  template <typename T>
+  void benchType(const char* typeName, std::size_t n, Checked::Kernel best) {
+    std::mt19937_64 rng { 7 };
+    std::vector<T> a(n), b(n), out(n), reference(n);
+
+    for (std::size_t i { 0 }; i < n; ++i) {
+      a[i] = static_cast<T>(static_cast<std::int32_t>(rng() % 60'001) - 30'000);
+      b[i] = static_cast<T>(static_cast<std::int32_t>(rng() % 60'001) - 30'000);
+    }
+
+    const std::size_t planted { n - n / 10 - 3 };
+    a[planted] = std::numeric_limits<T>::max() - 1;
+    b[planted] = 2;
+
+    std::cout << typeName << '\n';
+
+    for (Checked::Op op : { Checked::Op::add, Checked::Op::subtract, Checked::Op::multiply }) {
+      // subtract overflows at the planted row only if b is negative there
+      b[planted] = op == Checked::Op::subtract ? -2 : 2;
+
+      std::cout << opName(op) << '\n';
+
+      run<Checked::Wrap>    ("wrap scalar    ", op, Checked::Kernel::scalar, a, b, out, planted);
+      run<Checked::Report>  ("report scalar  ", op, Checked::Kernel::scalar, a, b, reference, planted);
+
+      if (best == Checked::Kernel::avx2 && sizeof(T) == 4) {
+        run<Checked::Wrap>    ("wrap avx2      ", op, Checked::Kernel::avx2, a, b, out, planted);
+        run<Checked::Report>  ("report avx2    ", op, Checked::Kernel::avx2, a, b, out, planted);
+
+        if (out != reference)
+          std::cout << "  [MISMATCH]\n";
+
+        run<Checked::Saturate>("saturate avx2  ", op, Checked::Kernel::avx2, a, b, out, planted);
+
+        // Every planted case overflows upwards
+        if (out[planted] != std::numeric_limits<T>::max())
+          std::cout << "  [NOT SATURATED]\n";
+      }
+
+      else {
+        run<Checked::Saturate>("saturate scalar", op, Checked::Kernel::scalar, a, b, out, planted);
+      }
+    }
+  }
+}
+
+int main(int argc, char** argv) {
+  const std::size_t n { argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 16ull << 20 };
+  const Checked::Kernel best { Checked::detectKernel() };
+
+  static_assert(Checked::add<Checked::Saturate>(std::numeric_limits<int>::max(), 1) == std::numeric_limits<int>::max());
+  static_assert(Checked::subtract<Checked::Saturate>(std::numeric_limits<int>::min(), 1) == std::numeric_limits<int>::min());
+  static_assert(Checked::multiply<Checked::Saturate>(-65'536, 65'536) == std::numeric_limits<int>::min());
+  static_assert(Checked::subtract<Checked::Saturate>(1u, 2u) == 0u);
+  static_assert(!Checked::add<Checked::Report>(std::numeric_limits<int>::max(), 1));
+  static_assert(Checked::add<Checked::Wrap>(std::numeric_limits<int>::max(), 1) == std::numeric_limits<int>::min());
+
+  benchType<std::int32_t>("int32", n, best);
+  benchType<std::int64_t>("int64", n, best);
+
+  return 0;
+}
@@ -0,0 +1,129 @@
+// +--------------------------------------------+
+// |      SENTENCE ASSEMBLY: FORMAT STRINGS     |
+// +--------------------------------------------+
+//
+// g++ -std=c++20 -O2 int_format.cpp bench_compiled_format.cpp -o bench_compiled_format
+// ./bench_compiled_format [sentences]   (default: 1'000'000)
+//
+// Builds "<name> has <count> <phrase> <apples>.\n" for every generated
+// record, the way quiz_apples describes a count, into one string:
+//
+//   - std::ostringstream with chained operator<< (what quiz_apples did)
+//   - std::format_to with a runtime-parsed format string, if available
+//   - std::snprintf
+//   - CompiledFormat::appendTo into a reused std::string
+//
+// All outputs are compared with the first.
+
+#include "compiled_format.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <iterator>
+#include <random>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#if __has_include(<format>)
+  #include <format>
+#endif
+
+namespace {
+  template <typename F>
+  double bestSeconds(F&& f) {
+    double best { 1e30 };
+
+    for (int rep { 0 }; rep < 3; ++rep) {
+      auto start { std::chrono::steady_clock::now() };
+      f();
+      best = std::min(best, std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+    }
+
+    return best;
+  }
+
+  struct Record {
+    std::string_view name;
+    int              count;
+    std::string_view phrase;
+    std::string_view apples;
+  };
+
+  void report(const char* method, std::size_t sentences, double seconds, bool same) {
+    std::cout << "  " << method << sentences / seconds / 1e6 << " M sentences/s" << (same ? "\n" : "  [MISMATCH]\n");
+  }
+}
+
+int main(int argc, char** argv) {
+  const std::size_t sentences { argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1'000'000ull };
+
+  constexpr std::string_view names[]   { "Mary", "You", "Alex", "Zoë", "Bartholomew", "Li" };
+  constexpr std::string_view phrases[] { "no", "a single", "a couple of", "a few", "many" };
+
+  std::mt19937 rng { 9 };
+  std::vector<Record> records(sentences);
+
+  for (Record& record : records) {
+    record.name   = names[rng() % std::size(names)];
+    record.count  = static_cast<int>(rng() % 1000);
+    record.phrase = phrases[std::min(record.count, 4)];
+    record.apples = record.count == 1 ? "apple" : "apples";
+  }
+
+  std::cout << sentences << " sentences\n";
+
+  std::string streamed { };
+  const double stream { bestSeconds([&] {
+    std::ostringstream out { };
+
+    for (const Record& r : records)
+      out << r.name << " has " << r.count << ' ' << r.phrase << ' ' << r.apples << ".\n";
+
+    streamed = out.str();
+  }) };
+  report("std::ostringstream <<:     ", sentences, stream, true);
+
+#ifdef __cpp_lib_format
+  std::string formatted { };
+  const double format { bestSeconds([&] {
+    formatted.clear();
+
+    for (const Record& r : records)
+      std::format_to(std::back_inserter(formatted), "{} has {} {} {}.\n", r.name, r.count, r.phrase, r.apples);
+  }) };
+  report("std::format_to:            ", sentences, format, formatted == streamed);
+#else
+  std::cout << "  std::format_to:            (not available in this standard library)\n";
+#endif
+
+  std::string printed { };
+  const double print { bestSeconds([&] {
+    printed.clear();
+    char line[128];
+
+    for (const Record& r : records) {
+      const int size { std::snprintf(line, sizeof(line), "%.*s has %d %.*s %.*s.\n",
+                                     static_cast<int>(r.name.size()), r.name.data(), r.count,
+                                     static_cast<int>(r.phrase.size()), r.phrase.data(),
+                                     static_cast<int>(r.apples.size()), r.apples.data()) };
+      printed.append(line, static_cast<std::size_t>(size));
+    }
+  }) };
+  report("std::snprintf:             ", sentences, print, printed == streamed);
+
+  std::string compiled { };
+  const double appended { bestSeconds([&] {
+    compiled.clear();
+
+    for (const Record& r : records)
+      CompiledFormat::appendTo<"{} has {} {} {}.\n">(compiled, r.name, r.count, r.phrase, r.apples);
+  }) };
+  report("CompiledFormat::appendTo:  ", sentences, appended, compiled == streamed);
+
+  return 0;
+}
@@ -0,0 +1,153 @@
+// +--------------------------------------------+
+// |         FAST I/O VS IOSTREAM THROUGHPUT    |
+// +--------------------------------------------+
+//
+// g++ -std=c++20 -O2 fast_io.cpp int_format.cpp int_parse.cpp float_parse.cpp bench_fast_io.cpp -o bench_fast_io
+// ./bench_fast_io [count] [file]   (default: 100M ints in /tmp/fast_io_ints.txt)
+//
+// Writes the integers once, then reads them back with std::ifstream >>,
+// with FastIO::Reader on the file (mmap) and on a pipe from cat (read(2)).
+// Output is compared by writing the same integers to /dev/null.
+
+#include "fast_io.h"
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <string>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace {
+  double secondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  }
+
+  // Same sequence every time, so the sums can be checked
+  std::int32_t value(std::mt19937& rng) {
+    return static_cast<std::int32_t>(rng()) >> static_cast<int>(rng() % 31);
+  }
+
+  void report(const char* name, std::size_t count, double seconds, std::int64_t sum, std::int64_t expected) {
+    std::cout << name << count / seconds / 1e6 << " M ints/s (" << seconds << " s)"
+              << (sum == expected ? "\n" : "  [WRONG SUM]\n");
+  }
+
+  std::int64_t readAll(FastIO::Reader& in, std::size_t count) {
+    std::int64_t sum { 0 };
+    std::int32_t x { };
+
+    for (std::size_t i { 0 }; i < count && in.read(x); ++i)
+      sum += x;
+
+    return sum;
+  }
+}
+
+int main(int argc, char** argv) {
+  const std::size_t count { argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 100'000'000ull };
+  const std::string path  { argc > 2 ? argv[2] : "/tmp/fast_io_ints.txt" };
+
+  std::int64_t expected { 0 };
+
+  // -- Writing --
+  {
+    std::mt19937 rng { 1 };
+    const int fd { open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644) };
+
+    if (fd < 0) {
+      std::cout << "cannot create " << path << '\n';
+      return 1;
+    }
+
+    FastIO::Writer out { fd };
+    auto start { std::chrono::steady_clock::now() };
+
+    for (std::size_t i { 0 }; i < count; ++i) {
+      const std::int32_t x { value(rng) };
+      expected += x;
+      out << x << (i % 16 == 15 ? '\n' : ' ');
+    }
+
+    out.flush();
+    std::cout << "wrote " << path << " in " << secondsSince(start) << " s\n";
+    close(fd);
+  }
+
+  {
+    std::mt19937 rng { 1 };
+    std::ofstream sink { "/dev/null" };
+    auto start { std::chrono::steady_clock::now() };
+
+    for (std::size_t i { 0 }; i < count; ++i)
+      sink << value(rng) << (i % 16 == 15 ? '\n' : ' ');
+
+    sink.flush();
+    const double seconds { secondsSince(start) };
+    std::cout << "write ofstream:      " << count / seconds / 1e6 << " M ints/s\n";
+  }
+
+  {
+    std::mt19937 rng { 1 };
+    const int fd { open("/dev/null", O_WRONLY) };
+    FastIO::Writer sink { fd };
+    auto start { std::chrono::steady_clock::now() };
+
+    for (std::size_t i { 0 }; i < count; ++i)
+      sink << value(rng) << (i % 16 == 15 ? '\n' : ' ');
+
+    sink.flush();
+    const double seconds { secondsSince(start) };
+    std::cout << "write FastIO:        " << count / seconds / 1e6 << " M ints/s\n";
+    close(fd);
+  }
+
+  // -- Reading --
+  {
+    std::ifstream in { path };
+    std::int64_t sum { 0 };
+    std::int32_t x { };
+    auto start { std::chrono::steady_clock::now() };
+
+    while (in >> x)
+      sum += x;
+
+    report("read ifstream >>:    ", count, secondsSince(start), sum, expected);
+  }
+
+  {
+    const int fd { open(path.c_str(), O_RDONLY) };
+    auto start { std::chrono::steady_clock::now() };
+    std::int64_t sum { };
+
+    {
+      FastIO::Reader in { fd };
+      sum = readAll(in, count);
+    }
+
+    report("read FastIO (mmap):  ", count, secondsSince(start), sum, expected);
+    close(fd);
+  }
+
+  {
+    std::FILE* pipe { popen(("cat '" + path + "'").c_str(), "r") };
+    auto start { std::chrono::steady_clock::now() };
+    std::int64_t sum { };
+
+    {
+      FastIO::Reader in { fileno(pipe) };
+      sum = readAll(in, count);
+    }
+
+    report("read FastIO (pipe):  ", count, secondsSince(start), sum, expected);
+    pclose(pipe);
+  }
+
+  std::remove(path.c_str());
+  return 0;
+}
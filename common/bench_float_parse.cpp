@@ -0,0 +1,173 @@
+// +--------------------------------------------+
+// |     FLOATING POINT PARSING THROUGHPUT      |
+// +--------------------------------------------+
+//
+// g++ -std=c++20 -O2 int_parse.cpp float_parse.cpp bench_float_parse.cpp -o bench_float_parse
+// ./bench_float_parse [count]   (default: 10M values)
+//
+// One number per line, in two flavours: short literals like the ones in
+// 03-constants_strings (6.02e23, 1.6e-19, 3.14159) and full round-trip
+// precision (17 significant digits, as printed by std::to_chars). Every
+// method must produce bit-identical doubles.
+//
+// First, literals at the edges of double and float that take the slow
+// path: halfway past the largest finite value (rounds to infinity) and
+// halfway to the smallest subnormal (rounds to 0), checked against strtod
+// and strtof.
+
+#include "float_parse.h"
+
+#include <charconv>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+  template <typename F>
+  double bestSeconds(F&& f) {
+    double best { 1e30 };
+
+    for (int rep { 0 }; rep < 3; ++rep) {
+      auto start { std::chrono::steady_clock::now() };
+      f();
+      best = std::min(best, std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+    }
+
+    return best;
+  }
+
+  std::string makeText(std::size_t n, bool shortLiterals) {
+    std::mt19937_64 rng { 9 };
+    std::uniform_real_distribution<double> mantissa { 1.0, 10.0 };
+    std::string text { };
+    char buffer[64];
+
+    for (std::size_t i { 0 }; i < n; ++i) {
+      const double value { mantissa(rng) * std::pow(10.0, static_cast<int>(rng() % 80) - 40) };
+      char* end { };
+
+      if (shortLiterals)
+        end = std::to_chars(buffer, buffer + sizeof(buffer), value, std::chars_format::general, 1 + static_cast<int>(rng() % 6)).ptr;
+      else
+        end = std::to_chars(buffer, buffer + sizeof(buffer), value, std::chars_format::scientific, 16).ptr;
+
+      text.append(buffer, end);
+      text += '\n';
+    }
+
+    return text;
+  }
+
+  // Long enough that w is truncated and w, w + 1 round apart
+  const char* const doubleBoundaries[] {
+    "179769313486231580793728971405303415079934132710037826936173778980444968292764750946649017977587207096330286416692887910946555547851940402630657488671505820681908902000708383676273854845817711531764475730270069855571366959622842914819860834936475292719074168444365510704342711559699508093042880177904174497792",
+    "-179769313486231580793728971405303415079934132710037826936173778980444968292764750946649017977587207096330286416692887910946555547851940402630657488671505820681908902000708383676273854845817711531764475730270069855571366959622842914819860834936475292719074168444365510704342711559699508093042880177904174497792",
+    "2.4703282292062327208828439643411068618252990130716238221279284125e-324",
+    "-2.4703282292062327208828439643411068618252990130716238221279284125e-324",
+  };
+
+  const char* const floatBoundaries[] {
+    "340282356779733661637539395458142568448",
+    "-340282356779733661637539395458142568448",
+    "7.00649232162408535461864791644958065640130970938257885878534141944895541342930300743319094181060791015625e-46",
+    "-7.00649232162408535461864791644958065640130970938257885878534141944895541342930300743319094181060791015625e-46",
+  };
+
+  template <typename T, typename Reference>
+  bool sameAsReference(const char* literal, Reference reference) {
+    T value { 1 };
+    const T expected { reference(literal, nullptr) };
+    const auto result { FloatParse::parse(literal, literal + std::strlen(literal), value) };
+
+    return result && std::memcmp(&value, &expected, sizeof(T)) == 0;
+  }
+
+  void checkBoundaries() {
+    bool same { true };
+
+    for (const char* literal : doubleBoundaries)
+      same = sameAsReference<double>(literal, std::strtod) && same;
+
+    for (const char* literal : floatBoundaries)
+      same = sameAsReference<float>(literal, std::strtof) && same;
+
+    std::cout << "overflow to infinity, underflow to 0" << (same ? "\n" : "  [MISMATCH]\n");
+  }
+
+  void bench(const char* name, std::size_t n, bool shortLiterals) {
+    const std::string text { makeText(n, shortLiterals) };
+    std::vector<double> values { }, reference { };
+
+    std::cout << name << " (" << text.size() / n << " bytes per value)\n";
+
+    auto report { [&](const char* method, double seconds) {
+      const bool same { values.size() == reference.size()
+                        && std::memcmp(values.data(), reference.data(), values.size() * sizeof(double)) == 0 };
+
+      std::cout << "  " << method << n / seconds / 1e6 << " M values/s, "
+                << text.size() / seconds / 1e9 << " GB/s" << (same ? "\n" : "  [MISMATCH]\n");
+    } };
+
+    const double fromChars { bestSeconds([&] {
+      values.clear();
+      values.reserve(n);
+
+      for (const char* p { text.data() }, *last { text.data() + text.size() }; p < last; ) {
+        double value { };
+        p = std::from_chars(p, last, value).ptr + 1;
+        values.push_back(value);
+      }
+    }) };
+
+    reference = values;
+    report("std::from_chars:    ", fromChars);
+
+    const double column { bestSeconds([&] {
+      values.clear();
+      FloatParse::parseColumn(text, values);
+    }) };
+
+    report("FloatParse column:  ", column);
+
+    const double strtod { bestSeconds([&] {
+      values.clear();
+      values.reserve(n);
+
+      for (const char* p { text.data() }; *p; ) {
+        char* end { };
+        values.push_back(std::strtod(p, &end));
+        p = end + 1;
+      }
+    }) };
+
+    report("std::strtod:        ", strtod);
+
+    const double stream { bestSeconds([&] {
+      values.clear();
+      values.reserve(n);
+
+      std::istringstream in { text };
+
+      for (double value { }; in >> value; )
+        values.push_back(value);
+    }) };
+
+    report("std::istringstream: ", stream);
+  }
+}
+
+int main(int argc, char** argv) {
+  const std::size_t n { argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 10'000'000ull };
+
+  checkBoundaries();
+  bench("short literals",  n, true);
+  bench("17 digits",       n, false);
+
+  return 0;
+}
@@ -0,0 +1,147 @@
+// +--------------------------------------------+
+// |      INTEGER FORMATTING THROUGHPUT         |
+// +--------------------------------------------+
+//
+// g++ -std=c++20 -O2 int_format.cpp bench_int_format.cpp -o bench_int_format
+// ./bench_int_format [count]   (default: 10M values per type)
+//
+// Build it again with -DINT_FORMAT_SCALAR to check the portable path that
+// targets without SSE2 use.
+//
+// Every method formats the same values, space separated, into one buffer;
+// outputs are checked against std::to_chars. Values have uniformly random
+// digit counts, so short and long numbers are equally common, after a set
+// of edge cases: powers of ten and their neighbours, 8-digit blocks that
+// are zero or start with zeros, and each type's limits.
+
+#include "int_format.h"
+
+#include <charconv>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <span>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#if __has_include(<format>)
+  #include <format>
+#endif
+
+namespace {
+  template <typename F>
+  double bestSeconds(F&& f) {
+    double best { 1e30 };
+
+    for (int rep { 0 }; rep < 3; ++rep) {
+      auto start { std::chrono::steady_clock::now() };
+      f();
+      best = std::min(best, std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+    }
+
+    return best;
+  }
+
+  template <typename T>
+  std::vector<T> randomValues(std::size_t n) {
+    std::vector<T> values { std::numeric_limits<T>::min(), std::numeric_limits<T>::max(), 0 };
+
+    for (std::uint64_t power { 1 }; power <= std::numeric_limits<T>::max() / 10; power *= 10) {
+      for (const std::uint64_t v : { power, 10 * power - 1, 10 * power, 10 * power + 1, 4 * power })
+        if (v <= static_cast<std::uint64_t>(std::numeric_limits<T>::max()))
+          values.push_back(static_cast<T>(v));
+    }
+
+    for (const std::uint64_t v : { 4'000'000'000ull, 150'731'701'022'113ull, 1'000'000'000'000'000'001ull, 12'000'000'000'000'345ull })
+      if (v <= static_cast<std::uint64_t>(std::numeric_limits<T>::max()))
+        values.push_back(static_cast<T>(v));
+
+    std::mt19937_64 rng { 5 };
+    const std::size_t edges { values.size() };
+    values.resize(std::max(n, edges));
+
+    for (T& v : std::span<T> { values }.subspan(edges)) {
+      const auto bits { static_cast<int>(rng() % (8 * sizeof(T))) };
+      v = static_cast<T>(rng() >> (64 - 8 * sizeof(T) + bits));
+
+      if (std::is_signed_v<T> && (rng() & 1))
+        v = static_cast<T>(-v);
+    }
+
+    return values;
+  }
+
+  template <typename T>
+  void benchType(const char* name, std::size_t n) {
+    const std::vector<T> values { randomValues<T>(n) };
+    std::string buffer(IntFormat::bulkCapacity(values.size()), '\0');
+    std::string reference { };
+
+    std::cout << name << '\n';
+
+    auto report { [&](const char* method, double seconds, const std::string& out) {
+      std::cout << "  " << method << n / seconds / 1e6 << " M values/s"
+                << (out == reference ? "\n" : "  [MISMATCH]\n");
+    } };
+
+    // std::to_chars is the reference output
+    std::size_t used { };
+    const double toChars { bestSeconds([&] {
+      char* p { buffer.data() };
+      char* end { buffer.data() + buffer.size() };
+
+      for (const T v : values) {
+        p = std::to_chars(p, end, v).ptr;
+        *p++ = ' ';
+      }
+
+      used = static_cast<std::size_t>(p - buffer.data());
+    }) };
+
+    reference.assign(buffer.data(), used);
+    report("std::to_chars:     ", toChars, reference);
+
+    const double bulk { bestSeconds([&] { used = IntFormat::writeAll(std::span<const T> { values }, ' ', buffer.data()); }) };
+    report("IntFormat bulk:    ", bulk, std::string { buffer.data(), used });
+
+#ifdef __cpp_lib_format
+    std::string formatted { };
+    const double format { bestSeconds([&] {
+      formatted.clear();
+
+      for (const T v : values)
+        std::format_to(std::back_inserter(formatted), "{} ", v);
+    }) };
+
+    report("std::format_to:    ", format, formatted);
+#else
+    std::cout << "  std::format_to:    (not available in this standard library)\n";
+#endif
+
+    std::string streamed { };
+    const double stream { bestSeconds([&] {
+      std::ostringstream out { };
+
+      for (const T v : values)
+        out << v << ' ';
+
+      streamed = out.str();
+    }) };
+
+    report("std::ostringstream:", stream, streamed);
+  }
+}
+
+int main(int argc, char** argv) {
+  const std::size_t n { argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 10'000'000ull };
+
+  benchType<std::int32_t> ("int32",  n);
+  benchType<std::int64_t> ("int64",  n);
+  benchType<std::uint64_t>("uint64", n);
+
+  return 0;
+}
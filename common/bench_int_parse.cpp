@@ -0,0 +1,139 @@
+// +--------------------------------------------+
+// |        INTEGER PARSING THROUGHPUT          |
+// +--------------------------------------------+
+//
+// g++ -std=c++20 -O2 int_parse.cpp bench_int_parse.cpp -o bench_int_parse
+// ./bench_int_parse [count]   (default: 10M fields per type)
+//
+// CSV-like input: 8 comma-separated fields per line, uniformly random digit
+// counts, about half negative. Every method walks the same text field by
+// field and must reach the same sum as std::from_chars. A second pass with
+// 1 field in 8 corrupted (a letter, or too many digits) times rejection.
+
+#include "int_parse.h"
+
+#include <charconv>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+
+namespace {
+  template <typename F>
+  double bestSeconds(F&& f) {
+    double best { 1e30 };
+
+    for (int rep { 0 }; rep < 3; ++rep) {
+      auto start { std::chrono::steady_clock::now() };
+      f();
+      best = std::min(best, std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+    }
+
+    return best;
+  }
+
+  template <typename T>
+  std::string csvText(std::size_t n, bool corrupt) {
+    std::mt19937_64 rng { 7 };
+    std::string text { };
+    char digits[24];
+
+    for (std::size_t i { 0 }; i < n; ++i) {
+      const auto bits { static_cast<int>(rng() % (8 * sizeof(T) - 1)) };
+      auto v { static_cast<T>(rng() >> (64 - 8 * sizeof(T) + 1 + bits)) };
+
+      if (rng() & 1)
+        v = static_cast<T>(-v);
+
+      std::string_view field { digits, static_cast<std::size_t>(std::to_chars(digits, digits + sizeof(digits), v).ptr - digits) };
+      text += field;
+
+      if (corrupt && rng() % 8 == 0)
+        text += rng() & 1 ? "x" : "99999999999999999999";
+
+      text += i % 8 == 7 ? '\n' : ',';
+    }
+
+    return text;
+  }
+
+  // Walks the fields; bad ones count in `rejected` and add nothing. Each
+  // parser returns where its field ends (at the separator) or nullptr.
+  template <typename T, typename Parse>
+  std::int64_t sumFields(const std::string& text, std::size_t& rejected, Parse parse) {
+    const char* p    { text.data() };
+    const char* last { text.data() + text.size() };
+    std::int64_t sum { 0 };
+    rejected = 0;
+
+    while (p < last) {
+      T value { };
+      const char* end { parse(p, last, value) };
+
+      if (end) {
+        sum += value;
+      }
+
+      else {
+        ++rejected;
+        end = p;
+
+        while (*end != ',' && *end != '\n')
+          ++end;
+      }
+
+      p = end + 1;
+    }
+
+    return sum;
+  }
+
+  template <typename T>
+  void benchType(const char* name, std::size_t n, bool corrupt) {
+    const std::string text { csvText<T>(n, corrupt) };
+    std::size_t rejected { }, expectedRejected { };
+    std::int64_t sum { }, reference { };
+
+    std::cout << name << (corrupt ? " (1 in 8 fields bad)\n" : "\n");
+
+    auto report { [&](const char* method, double seconds) {
+      std::cout << "  " << method << n / seconds / 1e6 << " M fields/s, "
+                << text.size() / seconds / 1e9 << " GB/s"
+                << (sum == reference && rejected == expectedRejected ? "\n" : "  [MISMATCH]\n");
+    } };
+
+    // Both parsers stop at the first non-digit, which must be the separator
+    const double fromChars { bestSeconds([&] {
+      sum = sumFields<T>(text, rejected, [](const char* first, const char* last, T& value) -> const char* {
+        const auto [end, ec] { std::from_chars(first, last, value) };
+        return ec == std::errc { } && (*end == ',' || *end == '\n') ? end : nullptr;
+      });
+    }) };
+
+    reference        = sum;
+    expectedRejected = rejected;
+    report("std::from_chars:", fromChars);
+
+    const double intParse { bestSeconds([&] {
+      sum = sumFields<T>(text, rejected, [](const char* first, const char* last, T& value) -> const char* {
+        const IntParse::Result result { IntParse::parseDelimited(first, last, ',', value) };
+        return result ? result.ptr : nullptr;
+      });
+    }) };
+
+    report("IntParse:       ", intParse);
+  }
+}
+
+int main(int argc, char** argv) {
+  const std::size_t n { argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 10'000'000ull };
+
+  for (const bool corrupt : { false, true }) {
+    benchType<std::int32_t>("int32", n, corrupt);
+    benchType<std::int64_t>("int64", n, corrupt);
+  }
+
+  return 0;
+}
@@ -0,0 +1,161 @@
+// +--------------------------------------------+
+// |      HEX / OCTAL / BINARY DUMP THROUGHPUT  |
+// +--------------------------------------------+
+//
+// g++ -std=c++20 -O2 radix_format.cpp bench_radix_format.cpp -o bench_radix_format
+// ./bench_radix_format [megabytes]   (default: 64 MiB of random bytes)
+//
+// The same buffer is dumped as "hh hh ..." hex, as "bbbbbbbb ..." binary
+// and as 0x-prefixed uint64 words. Each one is checked against the
+// per-element formatters it replaces.
+
+#include "radix_format.h"
+
+#include <bitset>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#if __has_include(<format>)
+  #include <format>
+#endif
+
+namespace {
+  template <typename F>
+  double bestSeconds(F&& f) {
+    double best { 1e30 };
+
+    for (int rep { 0 }; rep < 3; ++rep) {
+      auto start { std::chrono::steady_clock::now() };
+      f();
+      best = std::min(best, std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+    }
+
+    return best;
+  }
+
+  struct Case {
+    const char*          name;
+    RadixFormat::Options options;
+    const char*          formatSpec; // std::format equivalent of one element
+    std::size_t          valueBytes; // 1 for bytes, 8 for uint64 words
+  };
+
+  void report(const char* method, std::size_t bytes, double seconds, bool same) {
+    std::cout << "  " << method << bytes / seconds / 1e9 << " GB/s in" << (same ? "\n" : "  [MISMATCH]\n");
+  }
+
+  void benchCase(const Case& c, const std::vector<std::uint8_t>& buffer) {
+    std::vector<std::uint64_t> wordCopy(buffer.size() / 8);
+    std::memcpy(wordCopy.data(), buffer.data(), wordCopy.size() * 8);
+
+    const std::span<const std::uint8_t>  bytes { buffer };
+    const std::span<const std::uint64_t> words { wordCopy };
+    const std::size_t count { c.valueBytes == 1 ? bytes.size() : words.size() };
+
+    std::cout << c.name << '\n';
+
+    std::string reference { };
+    const double bulk { bestSeconds([&] {
+      reference.clear();
+
+      if (c.valueBytes == 1)
+        RadixFormat::appendAll(bytes, c.options, reference);
+      else
+        RadixFormat::appendAll(words, c.options, reference);
+    }) };
+
+    report("RadixFormat bulk:  ", buffer.size(), bulk, true);
+
+    // snprintf has no binary conversion
+    if (c.options.radix == RadixFormat::Radix::hex) {
+      std::string printed(reference.size() + 32, '\0');
+      std::size_t used { };
+
+      const double snprintf { bestSeconds([&] {
+        char* p { printed.data() };
+
+        for (std::size_t i { 0 }; i < count; ++i) {
+          if (c.valueBytes == 1)
+            p += std::snprintf(p, 4, "%02x ", bytes[i]);
+          else
+            p += std::snprintf(p, 24, "%#llx ", static_cast<unsigned long long>(words[i]));
+        }
+
+        used = static_cast<std::size_t>(p - printed.data());
+      }) };
+
+      report("std::snprintf:     ", buffer.size(), snprintf, std::string_view { printed.data(), used } == reference);
+    }
+
+#ifdef __cpp_lib_format
+    std::string formatted { };
+    const double format { bestSeconds([&] {
+      formatted.clear();
+
+      for (std::size_t i { 0 }; i < count; ++i) {
+        if (c.valueBytes == 1)
+          std::vformat_to(std::back_inserter(formatted), c.formatSpec, std::make_format_args(bytes[i]));
+        else
+          std::vformat_to(std::back_inserter(formatted), c.formatSpec, std::make_format_args(words[i]));
+      }
+    }) };
+
+    report("std::format_to:    ", buffer.size(), format, formatted == reference);
+#else
+    std::cout << "  std::format_to:    (not available in this standard library; wanted \"" << c.formatSpec << "\")\n";
+#endif
+
+    std::string streamed { };
+    const double stream { bestSeconds([&] {
+      std::ostringstream out { };
+
+      for (std::size_t i { 0 }; i < count; ++i) {
+        if (c.options.radix == RadixFormat::Radix::binary)
+          out << std::bitset<8> { bytes[i] } << ' ';
+        else if (c.valueBytes == 1)
+          out << std::hex << std::setw(2) << std::setfill('0') << static_cast<unsigned>(bytes[i]) << ' ';
+        else
+          out << std::hex << std::showbase << words[i] << ' ';
+      }
+
+      streamed = out.str();
+    }) };
+
+    report("std::ostringstream:", buffer.size(), stream, streamed == reference);
+  }
+}
+
+int main(int argc, char** argv) {
+  const std::size_t megabytes { argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 64ull };
+
+  std::vector<std::uint8_t> buffer(megabytes << 20);
+  std::mt19937_64 rng { 3 };
+
+  for (auto& b : buffer)
+    b = static_cast<std::uint8_t>(rng());
+
+  RadixFormat::Options hexBytes { };
+  RadixFormat::Options binaryBytes { };
+  binaryBytes.radix = RadixFormat::Radix::binary;
+  RadixFormat::Options hexWords { };
+  hexWords.prefix = true;
+
+  const Case cases[] {
+    { "bytes as hex (hh hh ...)",        hexBytes,    "{:02x} ",  1 },
+    { "bytes as binary (bbbbbbbb ...)",  binaryBytes, "{:08b} ",  1 },
+    { "uint64 words as 0x-prefixed hex", hexWords,    "{:#x} ",   8 },
+  };
+
+  for (const Case& c : cases)
+    benchCase(c, buffer);
+
+  return 0;
+}
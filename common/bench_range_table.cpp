@@ -0,0 +1,109 @@
+// +--------------------------------------------+
+// |      RANGE TABLE VS IF-CHAIN LOOKUPS       |
+// +--------------------------------------------+
+//
+// g++ -std=c++20 -O2 bench_range_table.cpp -o bench_range_table
+// ./bench_range_table [millions]   (default: 64 million lookups)
+//
+// quiz_apples' getQuantityPhrase as the original if/else chain and as a
+// RangeTable, on three kinds of apple counts:
+//
+//   random 0..5     every rule about equally likely: the chain mispredicts
+//   skewed          90% are "many", the rest spread over 0..3
+//   constant 3      perfectly predictable, the chain's best case
+//
+// Each loop sums the phrase lengths so the lookups cannot be dropped.
+
+#include "range_table.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string_view>
+#include <vector>
+
+namespace {
+  template <typename F>
+  double bestSeconds(F&& f) {
+    double best { 1e30 };
+
+    for (int rep { 0 }; rep < 3; ++rep) {
+      auto start { std::chrono::steady_clock::now() };
+      f();
+      best = std::min(best, std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+    }
+
+    return best;
+  }
+
+  // The chain quiz_apples had, minus its unreachable branches
+  [[gnu::noinline]] std::string_view quantityChain(unsigned int numApples) {
+    if (numApples == 0)
+      return "no";
+    else if (numApples == 1)
+      return "a single";
+    else if (numApples == 2)
+      return "a couple of";
+    else if (numApples == 3)
+      return "a few";
+    else
+      return "many";
+  }
+
+  constexpr RangeTable::Rule<std::string_view> quantityRules[] {
+    { 0, 0,                     "no"          },
+    { 1, 1,                     "a single"    },
+    { 2, 2,                     "a couple of" },
+    { 3, 3,                     "a few"       },
+    { 4, RangeTable::unbounded, "many"        },
+  };
+
+  constexpr auto quantityPhrases { RangeTable::make<RangeTable::denseSize(quantityRules)>(quantityRules) };
+
+  [[gnu::noinline]] std::string_view quantityTable(unsigned int numApples) {
+    return quantityPhrases[numApples];
+  }
+
+  template <typename Lookup>
+  std::size_t sumLengths(const std::vector<unsigned int>& counts, Lookup lookup) {
+    std::size_t sum { 0 };
+
+    for (const unsigned int count : counts)
+      sum += lookup(count).size();
+
+    return sum;
+  }
+
+  void bench(const char* name, const std::vector<unsigned int>& counts) {
+    std::size_t chainSum { }, tableSum { };
+    const double chain { bestSeconds([&] { chainSum = sumLengths(counts, quantityChain); }) };
+    const double table { bestSeconds([&] { tableSum = sumLengths(counts, quantityTable); }) };
+
+    std::cout << name << '\n'
+              << "  if-chain:    " << chain / static_cast<double>(counts.size()) * 1e9 << " ns/lookup\n"
+              << "  RangeTable:  " << table / static_cast<double>(counts.size()) * 1e9 << " ns/lookup"
+              << (chainSum == tableSum ? "\n" : "  [MISMATCH]\n");
+  }
+}
+
+int main(int argc, char** argv) {
+  const std::size_t millions { argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 64ull };
+  std::mt19937 rng { 8 };
+
+  std::vector<unsigned int> random(millions * 1'000'000), skewed(random.size()), constant(random.size(), 3);
+
+  for (auto& count : random)
+    count = rng() % 6;
+
+  for (auto& count : skewed)
+    count = rng() % 10 == 0 ? rng() % 4 : 4 + rng() % 1000;
+
+  bench("random 0..5", random);
+  bench("skewed, 90% many", skewed);
+  bench("constant 3", constant);
+
+  return 0;
+}
@@ -0,0 +1,131 @@
+// +--------------------------------------------+
+// |        UTF-8 VALIDATION THROUGHPUT         |
+// +--------------------------------------------+
+//
+// g++ -std=c++20 -O2 utf8.cpp bench_utf8.cpp -o bench_utf8
+// ./bench_utf8 [megabytes]   (default: 64 MiB per text)
+//
+// Three texts of valid UTF-8 (pure ASCII, Latin with accents, and CJK mixed
+// with emoji) are validated by the vector path and by the byte-at-a-time
+// state machine. Code point counting and decoding are timed as well. The
+// last case flips one byte near the end, so both validators must agree on
+// where the error is.
+
+#include "utf8.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+  template <typename F>
+  double bestSeconds(F&& f) {
+    double best { 1e30 };
+
+    for (int rep { 0 }; rep < 3; ++rep) {
+      auto start { std::chrono::steady_clock::now() };
+      f();
+      best = std::min(best, std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+    }
+
+    return best;
+  }
+
+  void append(std::string& text, char32_t c) {
+    if (c < 0x80) {
+      text += static_cast<char>(c);
+    } else if (c < 0x800) {
+      text += static_cast<char>(0xC0 | c >> 6);
+      text += static_cast<char>(0x80 | (c & 0x3F));
+    } else if (c < 0x10000) {
+      text += static_cast<char>(0xE0 | c >> 12);
+      text += static_cast<char>(0x80 | (c >> 6 & 0x3F));
+      text += static_cast<char>(0x80 | (c & 0x3F));
+    } else {
+      text += static_cast<char>(0xF0 | c >> 18);
+      text += static_cast<char>(0x80 | (c >> 12 & 0x3F));
+      text += static_cast<char>(0x80 | (c >> 6 & 0x3F));
+      text += static_cast<char>(0x80 | (c & 0x3F));
+    }
+  }
+
+  // Random words drawn from `alphabet`, separated by spaces
+  std::string makeText(std::size_t bytes, const std::vector<char32_t>& alphabet, std::mt19937_64& rng) {
+    std::string text { };
+    text.reserve(bytes + 16);
+
+    while (text.size() < bytes) {
+      const auto length { 1 + rng() % 8 };
+
+      for (std::size_t i { 0 }; i < length; ++i)
+        append(text, alphabet[rng() % alphabet.size()]);
+
+      text += ' ';
+    }
+
+    return text;
+  }
+
+  void report(const char* method, std::size_t bytes, double seconds, bool same) {
+    std::cout << "  " << method << bytes / seconds / 1e9 << " GB/s" << (same ? "\n" : "  [MISMATCH]\n");
+  }
+
+  void benchText(const char* name, const std::string& text) {
+    std::cout << name << " (" << text.size() << " bytes)\n";
+
+    std::size_t simd { }, scalar { };
+    const double vector { bestSeconds([&] { simd = Utf8::firstInvalid(text); }) };
+    const double machine { bestSeconds([&] { scalar = Utf8::firstInvalidScalar(text); }) };
+    report("Utf8::firstInvalid:      ", text.size(), vector, true);
+    report("scalar state machine:    ", text.size(), machine, simd == scalar);
+
+    if (scalar != Utf8::npos) {
+      std::cout << "  first invalid byte at " << scalar << '\n';
+      return;
+    }
+
+    std::size_t counted { };
+    const double count { bestSeconds([&] { counted = Utf8::countCodePoints(text); }) };
+    report("Utf8::countCodePoints:   ", text.size(), count, true);
+
+    std::vector<char32_t> decoded(text.size());
+    std::size_t length { };
+    const double decode { bestSeconds([&] { length = Utf8::decode(text, decoded.data()); }) };
+    report("Utf8::decode:            ", text.size(), decode, length == counted);
+  }
+}
+
+int main(int argc, char** argv) {
+  const std::size_t megabytes { argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 64ull };
+  const std::size_t bytes { megabytes << 20 };
+  std::mt19937_64 rng { 5 };
+
+  std::vector<char32_t> ascii { };
+  for (char32_t c { 'a' }; c <= 'z'; ++c)
+    ascii.push_back(c);
+
+  // Mostly ASCII with the odd accented letter, like French or German text
+  std::vector<char32_t> latin { ascii };
+  for (const char32_t c : { U'é', U'è', U'à', U'ü', U'ö', U'ß', U'ç' })
+    latin.push_back(c);
+
+  std::vector<char32_t> cjk { };
+  for (char32_t c { 0x4E00 }; c < 0x4E80; ++c)
+    cjk.push_back(c);
+  for (char32_t c { 0x1F600 }; c < 0x1F620; ++c)
+    cjk.push_back(c);
+
+  benchText("ASCII",         makeText(bytes, ascii, rng));
+  benchText("Latin",         makeText(bytes, latin, rng));
+  benchText("CJK and emoji", makeText(bytes, cjk, rng));
+
+  std::string broken { makeText(bytes, latin, rng) };
+  broken[broken.size() - 100] = '\xC0';
+  benchText("Latin, one bad byte near the end", broken);
+
+  return 0;
+}
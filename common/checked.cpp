@@ -0,0 +1,163 @@
+#include "checked.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+  #include <immintrin.h>
+  #define CHECKED_X86 1
+#endif
+
+namespace Checked {
+  namespace {
+    template <typename Policy, typename T>
+    std::size_t applyScalar(Op op, const T* a, const T* b, T* out, std::size_t begin, std::size_t n) {
+      std::size_t first { n };
+
+      for (std::size_t i { begin }; i < n; ++i) {
+        T r { };
+        bool overflow { };
+        bool towardsMax { };
+
+        switch (op) {
+          case Op::add:
+            overflow   = __builtin_add_overflow(a[i], b[i], &r);
+            towardsMax = a[i] >= 0;
+            break;
+
+          case Op::subtract:
+            overflow   = __builtin_sub_overflow(a[i], b[i], &r);
+            towardsMax = a[i] >= 0;
+            break;
+
+          default:
+            overflow   = __builtin_mul_overflow(a[i], b[i], &r);
+            towardsMax = (a[i] < 0) == (b[i] < 0);
+            break;
+        }
+
+        if constexpr (std::is_same_v<Policy, Saturate>)
+          out[i] = overflow ? detail::clamp<T>(towardsMax) : r;
+        else
+          out[i] = r;
+
+        if constexpr (!std::is_same_v<Policy, Wrap>) {
+          if (overflow && first == n)
+            first = i;
+        }
+      }
+
+      return first;
+    }
+
+#ifdef CHECKED_X86
+    // Lanes whose sign bit is set in `overflow` get the clamp that matches
+    // the sign bit of `towardsMin` (INT_MIN when set, INT_MAX otherwise)
+    __attribute__((target("avx2")))
+    __m256i saturate(__m256i r, __m256i overflow, __m256i towardsMin) {
+      const __m256i clamp { _mm256_xor_si256(_mm256_srai_epi32(towardsMin, 31), _mm256_set1_epi32(std::numeric_limits<std::int32_t>::max())) };
+
+      return _mm256_castps_si256(_mm256_blendv_ps(_mm256_castsi256_ps(r), _mm256_castsi256_ps(clamp), _mm256_castsi256_ps(overflow)));
+    }
+
+    // Returns how many elements were done; `first` is lowered to the first overflow seen
+    template <typename Policy>
+    __attribute__((target("avx2")))
+    std::size_t applyAvx2(Op op, const std::int32_t* a, const std::int32_t* b, std::int32_t* out,
+                          std::size_t n, std::size_t& first) {
+      std::size_t i { 0 };
+
+      for (; i + 8 <= n; i += 8) {
+        const __m256i va { _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i)) };
+        const __m256i vb { _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i)) };
+        __m256i r { }, overflow { }, towardsMin { };
+
+        switch (op) {
+          case Op::add:
+            r = _mm256_add_epi32(va, vb);
+
+            // Both operands differ in sign from the result
+            overflow   = _mm256_and_si256(_mm256_xor_si256(va, r), _mm256_xor_si256(vb, r));
+            towardsMin = va;
+            break;
+
+          case Op::subtract:
+            r = _mm256_sub_epi32(va, vb);
+
+            // Operands differ in sign and the result took b's sign
+            overflow   = _mm256_and_si256(_mm256_xor_si256(va, vb), _mm256_xor_si256(va, r));
+            towardsMin = va;
+            break;
+
+          default: {
+            if constexpr (std::is_same_v<Policy, Wrap>) {
+              r = _mm256_mullo_epi32(va, vb);
+              break;
+            }
+
+            // Full 64-bit products of the even and odd lanes
+            const __m256i even { _mm256_mul_epi32(va, vb) };
+            const __m256i odd  { _mm256_mul_epi32(_mm256_srli_epi64(va, 32), _mm256_srli_epi64(vb, 32)) };
+
+            r = _mm256_blend_epi32(even, _mm256_slli_epi64(odd, 32), 0b1010'1010);
+
+            // The product fits when its high half is the sign extension of the low half
+            const __m256i evenFits { _mm256_cmpeq_epi32(_mm256_srli_epi64(even, 32), _mm256_srai_epi32(even, 31)) };
+            const __m256i oddFits  { _mm256_cmpeq_epi32(odd, _mm256_slli_epi64(_mm256_srai_epi32(odd, 31), 32)) };
+            const __m256i fits     { _mm256_blend_epi32(evenFits, oddFits, 0b1010'1010) };
+
+            overflow   = _mm256_xor_si256(fits, _mm256_set1_epi32(-1));
+            towardsMin = _mm256_xor_si256(va, vb);
+            break;
+          }
+        }
+
+        if constexpr (std::is_same_v<Policy, Saturate>)
+          r = saturate(r, overflow, towardsMin);
+
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), r);
+
+        if constexpr (!std::is_same_v<Policy, Wrap>) {
+          const unsigned mask { static_cast<unsigned>(_mm256_movemask_ps(_mm256_castsi256_ps(overflow))) };
+
+          if (mask && first == n)
+            first = i + static_cast<std::size_t>(__builtin_ctz(mask));
+        }
+      }
+
+      return i;
+    }
+#endif
+  }
+
+  Kernel detectKernel() {
+#ifdef CHECKED_X86
+    static const Kernel best { __builtin_cpu_supports("avx2") ? Kernel::avx2 : Kernel::scalar };
+    return best;
+#else
+    return Kernel::scalar;
+#endif
+  }
+
+  template <typename Policy, typename T>
+  std::size_t apply(Op op, const T* a, const T* b, T* out, std::size_t n, [[maybe_unused]] Kernel kernel) {
+    std::size_t first { n };
+    std::size_t done  { 0 };
+
+    // There is no 64-bit multiply-high in AVX2, so int64 stays scalar
+#ifdef CHECKED_X86
+    if constexpr (std::is_same_v<T, std::int32_t>) {
+      if (kernel == Kernel::avx2)
+        done = applyAvx2<Policy>(op, a, b, out, n, first);
+    }
+#endif
+
+    const std::size_t tail { applyScalar<Policy>(op, a, b, out, done, n) };
+
+    return first < n ? first : tail;
+  }
+
+  template std::size_t apply<Wrap>    (Op, const std::int32_t*, const std::int32_t*, std::int32_t*, std::size_t, Kernel);
+  template std::size_t apply<Saturate>(Op, const std::int32_t*, const std::int32_t*, std::int32_t*, std::size_t, Kernel);
+  template std::size_t apply<Report>  (Op, const std::int32_t*, const std::int32_t*, std::int32_t*, std::size_t, Kernel);
+  template std::size_t apply<Wrap>    (Op, const std::int64_t*, const std::int64_t*, std::int64_t*, std::size_t, Kernel);
+  template std::size_t apply<Saturate>(Op, const std::int64_t*, const std::int64_t*, std::int64_t*, std::size_t, Kernel);
+  template std::size_t apply<Report>  (Op, const std::int64_t*, const std::int64_t*, std::int64_t*, std::size_t, Kernel);
+}
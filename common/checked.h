@@ -0,0 +1,98 @@
+// +--------------------------------------------+
+// |        OVERFLOW-AWARE INTEGER ARITHMETIC   |
+// +--------------------------------------------+
+//
+// Signed overflow is undefined behavior, and in practice it wraps silently.
+// These functions make the choice explicit with a policy picked at compile
+// time:
+//
+//   Wrap      two's complement wraparound (what the hardware does)
+//   Saturate  clamp to the type's minimum/maximum
+//   Report    std::nullopt instead of a wrong answer
+//
+//   Checked::add<Checked::Report>(INT_MAX, 1)   // std::nullopt
+//   Checked::add<Checked::Saturate>(INT_MAX, 1) // INT_MAX
+//
+// The scalar functions are header-only (__builtin_*_overflow). The array
+// kernels in checked.cpp use AVX2 for int32 when the CPU has it.
+
+#pragma once
+
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <type_traits>
+
+namespace Checked {
+  struct Wrap     { };
+  struct Saturate { };
+  struct Report   { };
+
+  template <typename Policy, typename T>
+  using Result = std::conditional_t<std::is_same_v<Policy, Report>, std::optional<T>, T>;
+
+  namespace detail {
+    // Where the true result went when it left T's range
+    template <std::integral T>
+    constexpr T clamp(bool towardsMax) {
+      return towardsMax ? std::numeric_limits<T>::max() : std::numeric_limits<T>::min();
+    }
+
+    template <typename Policy, std::integral T>
+    constexpr Result<Policy, T> resolve(T wrapped, bool overflow, bool towardsMax) {
+      if constexpr (std::is_same_v<Policy, Saturate>)
+        return overflow ? clamp<T>(towardsMax) : wrapped;
+      else if constexpr (std::is_same_v<Policy, Report>)
+        return overflow ? std::nullopt : std::optional<T> { wrapped };
+      else
+        return wrapped;
+    }
+  }
+
+  template <typename Policy, std::integral T>
+  constexpr Result<Policy, T> add(T a, T b) {
+    T r { };
+    const bool overflow { __builtin_add_overflow(a, b, &r) };
+
+    // Unsigned can only overflow upwards; signed goes the way a points
+    return detail::resolve<Policy>(r, overflow, std::is_unsigned_v<T> || a >= 0);
+  }
+
+  template <typename Policy, std::integral T>
+  constexpr Result<Policy, T> subtract(T a, T b) {
+    T r { };
+    const bool overflow { __builtin_sub_overflow(a, b, &r) };
+
+    return detail::resolve<Policy>(r, overflow, std::is_signed_v<T> && a >= 0);
+  }
+
+  template <typename Policy, std::integral T>
+  constexpr Result<Policy, T> multiply(T a, T b) {
+    T r { };
+    const bool overflow { __builtin_mul_overflow(a, b, &r) };
+
+    return detail::resolve<Policy>(r, overflow, (a < 0) == (b < 0));
+  }
+
+  enum class Op { add, subtract, multiply };
+
+  enum class Kernel { scalar, avx2 };
+
+  // Widest kernel this CPU can run
+  Kernel detectKernel();
+
+  // out[i] = a[i] op b[i] under Policy. Returns the index of the first element
+  // that overflowed, or n if none did. Report stores the wrapped value there.
+  // Wrap never checks and always returns n.
+  template <typename Policy, typename T>
+  std::size_t apply(Op op, const T* a, const T* b, T* out, std::size_t n, Kernel kernel = detectKernel());
+
+  extern template std::size_t apply<Wrap>    (Op, const std::int32_t*, const std::int32_t*, std::int32_t*, std::size_t, Kernel);
+  extern template std::size_t apply<Saturate>(Op, const std::int32_t*, const std::int32_t*, std::int32_t*, std::size_t, Kernel);
+  extern template std::size_t apply<Report>  (Op, const std::int32_t*, const std::int32_t*, std::int32_t*, std::size_t, Kernel);
+  extern template std::size_t apply<Wrap>    (Op, const std::int64_t*, const std::int64_t*, std::int64_t*, std::size_t, Kernel);
+  extern template std::size_t apply<Saturate>(Op, const std::int64_t*, const std::int64_t*, std::int64_t*, std::size_t, Kernel);
+  extern template std::size_t apply<Report>  (Op, const std::int64_t*, const std::int64_t*, std::int64_t*, std::size_t, Kernel);
+}
@@ -0,0 +1,170 @@
+// +--------------------------------------------+
+// |       COMPILE-TIME PARSED FORMAT STRINGS   |
+// +--------------------------------------------+
+//
+// quiz_apples builds each sentence with five chained operator<< calls, and
+// std::format parses its format string again on every call (and is not in
+// every standard library yet). Here the pattern is a template argument:
+//
+//   std::string line { };
+//   CompiledFormat::appendTo<"{} has {} {}.\n">(line, name, phrase, plural);
+//
+// The pattern is parsed once, at compile time, into its literal segments
+// (with {{ and }} unescaped) and a field count, so each literal is a
+// memcpy of a constant length and a wrong number of arguments is a
+// compile error. A call first works out an upper bound of its output
+// (literals, plus each string's size, 1 per char, IntFormat::maxChars per
+// integer), grows the buffer once, and then writes straight into it.
+// Reusing the buffer (clear() keeps its capacity) means no allocation per
+// call.
+//
+// Arguments: anything convertible to std::string_view, char, and any other
+// integer type (written by IntFormat; link common/int_format.cpp).
+
+#pragma once
+
+#include "int_format.h"
+
+#include <concepts>
+#include <cstddef>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <utility>
+
+namespace CompiledFormat {
+  // A string literal as a template argument
+  template <std::size_t N>
+  struct Pattern {
+    char text[N] { };
+
+    consteval Pattern(const char (&literal)[N]) {
+      for (std::size_t i { 0 }; i < N; ++i)
+        text[i] = literal[i];
+    }
+  };
+
+  template <typename T>
+  concept Argument = std::convertible_to<const T&, std::string_view>
+                  || (std::integral<T> && !std::same_as<T, bool>);
+
+  namespace detail {
+    template <std::size_t N>
+    struct Parsed {
+      char        literals[N] { }; // every literal segment, unescaped, back to back
+      std::size_t ends[N]     { }; // ends[i]: end of segment i in literals
+      std::size_t fields      { 0 };
+    };
+
+    template <std::size_t N>
+    consteval Parsed<N> parse(const Pattern<N>& pattern) {
+      Parsed<N> parsed { };
+      std::size_t used { 0 };
+
+      // N - 1: the terminator is not part of the pattern
+      for (std::size_t i { 0 }; i < N - 1; ++i) {
+        const char c { pattern.text[i] };
+
+        if (c == '{' && pattern.text[i + 1] == '{') {
+          parsed.literals[used++] = '{';
+          ++i;
+        }
+
+        else if (c == '{' && pattern.text[i + 1] == '}') {
+          parsed.ends[parsed.fields++] = used;
+          ++i;
+        }
+
+        else if (c == '}' && pattern.text[i + 1] == '}') {
+          parsed.literals[used++] = '}';
+          ++i;
+        }
+
+        else if (c == '{' || c == '}') {
+          throw "CompiledFormat: only {}, {{ and }} may use braces";
+        }
+
+        else {
+          parsed.literals[used++] = c;
+        }
+      }
+
+      parsed.ends[parsed.fields] = used;
+      return parsed;
+    }
+
+    template <Pattern P>
+    inline constexpr auto parsed { parse(P) };
+
+    // Literal segment I, whose length is known at compile time
+    template <Pattern P, std::size_t I>
+    char* writeLiteral(char* out) {
+      constexpr std::size_t begin { I == 0 ? 0 : parsed<P>.ends[I - 1] };
+      constexpr std::size_t size  { parsed<P>.ends[I] - begin };
+
+      if constexpr (size > 0)
+        std::memcpy(out, parsed<P>.literals + begin, size);
+
+      return out + size;
+    }
+
+    template <Argument T>
+    std::size_t maxChars(const T& argument) {
+      if constexpr (std::convertible_to<const T&, std::string_view>)
+        return std::string_view { argument }.size();
+      else if constexpr (std::same_as<T, char>)
+        return 1;
+      else
+        return IntFormat::maxChars;
+    }
+
+    template <Argument T>
+    char* writeArgument(char* out, const T& argument) {
+      if constexpr (std::convertible_to<const T&, std::string_view>) {
+        const std::string_view text { argument };
+        std::memcpy(out, text.data(), text.size());
+        return out + text.size();
+      }
+
+      else if constexpr (std::same_as<T, char>) {
+        *out = argument;
+        return out + 1;
+      }
+
+      else {
+        return IntFormat::write(out, argument);
+      }
+    }
+
+    template <Pattern P, std::size_t... I, Argument... Args>
+    char* writeAll(char* out, std::index_sequence<I...>, const Args&... args) {
+      ((out = writeLiteral<P, I>(out), out = writeArgument(out, args)), ...);
+      return writeLiteral<P, sizeof...(Args)>(out);
+    }
+  }
+
+  // Upper bound of what formatTo writes for these arguments
+  template <Pattern P, Argument... Args>
+  std::size_t maxChars(const Args&... args) {
+    return detail::parsed<P>.ends[detail::parsed<P>.fields] + (std::size_t { 0 } + ... + detail::maxChars(args));
+  }
+
+  // Writes the pattern with its fields filled in at out (maxChars bytes);
+  // returns one past the last character
+  template <Pattern P, Argument... Args>
+  char* formatTo(char* out, const Args&... args) {
+    static_assert(detail::parsed<P>.fields == sizeof...(Args), "CompiledFormat: number of {} and of arguments differ");
+
+    return detail::writeAll<P>(out, std::index_sequence_for<Args...> { }, args...);
+  }
+
+  // Same, appended to out
+  template <Pattern P, Argument... Args>
+  void appendTo(std::string& out, const Args&... args) {
+    const std::size_t used { out.size() };
+    out.resize(used + maxChars<P>(args...));
+
+    char* end { formatTo<P>(out.data() + used, args...) };
+    out.resize(static_cast<std::size_t>(end - out.data()));
+  }
+}
@@ -0,0 +1,41 @@
+// +--------------------------------------------+
+// |         CONSOLE: IOSTREAM OR FAST I/O      |
+// +--------------------------------------------+
+//
+// The quiz programs read and write through Console::in / Console::out.
+// By default these are std::cin / std::cout. Build with -DUSE_FAST_IO (and
+// link common/fast_io.cpp, int_format.cpp, int_parse.cpp and float_parse.cpp)
+// to swap in the buffered FastIO reader and writer without touching the
+// program:
+//
+//   g++ -std=c++20 -O2 -pthread -DUSE_FAST_IO prime_number.cpp primes/miller_rabin.cpp primes/prime_cache.cpp primes/sieve.cpp
+//       ../../common/fast_io.cpp ../../common/int_format.cpp ../../common/int_parse.cpp ../../common/float_parse.cpp
+
+#pragma once
+
+#include <string>
+
+#ifdef USE_FAST_IO
+  #include "fast_io.h"
+#else
+  #include <iostream>
+#endif
+
+namespace Console {
+#ifdef USE_FAST_IO
+  inline FastIO::Writer out { 1 };
+  inline FastIO::Reader in  { 0, &out };
+
+  // Skips leading whitespace, then reads the rest of the line
+  inline bool readLine(std::string& line) {
+    return in.skipWhitespace() && in.readLine(line);
+  }
+#else
+  inline std::ostream& out { std::cout };
+  inline std::istream& in  { std::cin };
+
+  inline bool readLine(std::string& line) {
+    return static_cast<bool>(std::getline(in >> std::ws, line));
+  }
+#endif
+}
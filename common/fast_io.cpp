@@ -0,0 +1,240 @@
+#include "fast_io.h"
+
+#include "float_parse.h"
+
+#include <algorithm>
+#include <cerrno>
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace FastIO {
+  namespace {
+    constexpr std::size_t chunkBytes { 1 << 20 };
+  }
+
+  // -- Writer --
+  Writer::Writer(int fd, std::size_t capacity)
+    : m_fd { fd }, m_buffer(capacity < 64 ? 64 : capacity) { }
+
+  Writer::~Writer() {
+    flush();
+  }
+
+  void Writer::write(double value) {
+    if (m_buffer.size() - m_used < 32)
+      flush();
+
+    char* at  { m_buffer.data() + m_used };
+    char* end { m_buffer.data() + m_buffer.size() };
+
+    m_used = static_cast<std::size_t>(std::to_chars(at, end, value, std::chars_format::general, 6).ptr - m_buffer.data());
+  }
+
+  bool Writer::flush() {
+    writeAll(m_buffer.data(), m_used);
+    m_used = 0;
+
+    return !m_failed;
+  }
+
+  void Writer::writeAll(const char* data, std::size_t size) {
+    while (size > 0 && !m_failed) {
+      const ssize_t n { ::write(m_fd, data, size) };
+
+      if (n < 0 && errno == EINTR)
+        continue;
+
+      if (n <= 0) {
+        m_failed = true;
+        break;
+      }
+
+      data += n;
+      size -= static_cast<std::size_t>(n);
+    }
+  }
+
+  // -- Reader --
+  Reader::Reader(int fd, Writer* tied)
+    : m_fd { fd }, m_tied { tied } {
+    struct stat info { };
+
+    // A regular file can be mapped whole: no copies, no refills
+    if (fstat(fd, &info) == 0 && S_ISREG(info.st_mode) && info.st_size > 0) {
+      const auto size { static_cast<std::size_t>(info.st_size) };
+      void* map { mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0) };
+
+      if (map != MAP_FAILED) {
+        madvise(map, size, MADV_SEQUENTIAL);
+
+        m_map  = map;
+        m_data = static_cast<const char*>(map);
+        m_end  = size;
+        m_eof  = true;
+
+        // Start where the descriptor is, in case some of it was already read
+        const off_t offset { lseek(fd, 0, SEEK_CUR) };
+        m_pos = offset > 0 ? std::min(static_cast<std::size_t>(offset), size) : 0;
+
+        return;
+      }
+    }
+
+    m_buffer.resize(chunkBytes);
+    m_data = m_buffer.data();
+  }
+
+  Reader::~Reader() {
+    if (m_map)
+      munmap(m_map, m_end);
+  }
+
+  // Keeps [m_pos, m_end) and appends whatever read(2) returns after it
+  bool Reader::refill() {
+    if (m_eof)
+      return false;
+
+    if (m_tied)
+      m_tied->flush();
+
+    std::memmove(m_buffer.data(), m_buffer.data() + m_pos, m_end - m_pos);
+    m_dropped += m_pos;
+    m_end     -= m_pos;
+    m_pos  = 0;
+
+    // A single token longer than the buffer
+    if (m_end == m_buffer.size())
+      m_buffer.resize(2 * m_buffer.size());
+
+    m_data = m_buffer.data();
+
+    for (;;) {
+      const ssize_t n { ::read(m_fd, m_buffer.data() + m_end, m_buffer.size() - m_end) };
+
+      if (n < 0 && errno == EINTR)
+        continue;
+
+      if (n <= 0) {
+        m_eof = true;
+        return false;
+      }
+
+      m_end += static_cast<std::size_t>(n);
+      return true;
+    }
+  }
+
+  bool Reader::skipWhitespace() {
+    for (;;) {
+      while (m_pos < m_end && isSpace(m_data[m_pos]))
+        ++m_pos;
+
+      if (m_pos < m_end)
+        return true;
+
+      if (!refill())
+        return false;
+    }
+  }
+
+  std::string_view Reader::token() {
+    if (!skipWhitespace())
+      return { };
+
+    std::size_t i { m_pos };
+
+    for (;;) {
+      while (i < m_end && !isSpace(m_data[i]))
+        ++i;
+
+      if (i < m_end || m_eof)
+        break;
+
+      // The token runs past the buffer; refill moves it to the front
+      const std::size_t scanned { i - m_pos };
+      const bool more { refill() };
+      i = m_pos + scanned;
+
+      if (!more)
+        break;
+    }
+
+    const std::string_view t { m_data + m_pos, i - m_pos };
+    m_pos = i;
+
+    return t;
+  }
+
+  std::string_view Reader::lines(std::size_t maxBytes) {
+    for (;;) {
+      const char*       from      { m_data + m_pos };
+      const std::size_t available { m_end - m_pos };
+      const std::size_t window    { std::min(available, maxBytes) };
+
+      if (const void* newline { memrchr(from, '\n', window) }) {
+        const std::size_t length { static_cast<std::size_t>(static_cast<const char*>(newline) - from) + 1 };
+        m_pos += length;
+
+        return { from, length };
+      }
+
+      // A single line longer than maxBytes: look at everything buffered
+      if (available > maxBytes) {
+        maxBytes = available;
+        continue;
+      }
+
+      if (m_eof) {
+        m_pos = m_end;
+        return { from, available };
+      }
+
+      refill();
+    }
+  }
+
+  bool Reader::read(double& value) {
+    const std::string_view t { token() };
+    const FloatParse::Result result { FloatParse::parse(t.data(), t.data() + t.size(), value) };
+
+    return check(!t.empty() && result && result.ptr == t.data() + t.size());
+  }
+
+  bool Reader::read(std::string& word) {
+    const std::string_view t { token() };
+    word.assign(t);
+
+    return check(!t.empty());
+  }
+
+  bool Reader::readChar(char& c) {
+    if (!check(skipWhitespace()))
+      return false;
+
+    c = m_data[m_pos++];
+    return true;
+  }
+
+  bool Reader::readLine(std::string& line) {
+    line.clear();
+
+    for (;;) {
+      const char* from { m_data + m_pos };
+      const auto* newline { static_cast<const char*>(std::memchr(from, '\n', m_end - m_pos)) };
+
+      if (newline) {
+        line.append(from, newline);
+        m_pos = static_cast<std::size_t>(newline - m_data) + 1;
+        return true;
+      }
+
+      line.append(from, m_end - m_pos);
+      m_pos = m_end;
+
+      if (!refill())
+        return check(!line.empty());
+    }
+  }
+}
@@ -0,0 +1,248 @@
+// +--------------------------------------------+
+// |           BUFFERED STDIN / STDOUT          |
+// +--------------------------------------------+
+//
+// Drop-in replacements for std::cin >> / std::cout << when the input is
+// large:
+//
+//   Reader  maps the input if it is a regular file, otherwise read(2)s it
+//           in 1 MiB chunks, and hands out whitespace-separated tokens
+//           (int32/int64 with IntParse, doubles with FloatParse, the rest
+//           with std::from_chars).
+//   Writer  formats into a 1 MiB buffer (integers with IntFormat, doubles
+//           with std::to_chars) and write(2)s it when full, on flush() or
+//           on destruction.
+//
+// Like std::cin and std::cout, a Reader can be tied to a Writer so prompts
+// are flushed before the reader blocks for more input.
+
+#pragma once
+
+#include "int_format.h"
+#include "int_parse.h"
+
+#include <charconv>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+namespace FastIO {
+  class Writer {
+  public:
+    explicit Writer(int fd = 1, std::size_t capacity = 1 << 20);
+    ~Writer();
+
+    Writer(const Writer&) = delete;
+    Writer& operator=(const Writer&) = delete;
+
+    void put(char c) {
+      if (m_used == m_buffer.size())
+        flush();
+
+      m_buffer[m_used++] = c;
+    }
+
+    void write(std::string_view text) {
+      if (text.size() > m_buffer.size() - m_used) {
+        flush();
+
+        // Too big to buffer: straight through
+        if (text.size() > m_buffer.size()) {
+          writeAll(text.data(), text.size());
+          return;
+        }
+      }
+
+      std::memcpy(m_buffer.data() + m_used, text.data(), text.size());
+      m_used += text.size();
+    }
+
+    template <std::integral T>
+    void write(T value) {
+      if constexpr (std::same_as<T, char>) {
+        put(value);
+      }
+
+      else if constexpr (std::same_as<T, bool>) {
+        put(value ? '1' : '0');
+      }
+
+      else {
+        if (m_buffer.size() - m_used < IntFormat::maxChars)
+          flush();
+
+        m_used = static_cast<std::size_t>(IntFormat::write(m_buffer.data() + m_used, value) - m_buffer.data());
+      }
+    }
+
+    // Six significant digits, the same as std::cout's default
+    void write(double value);
+
+    // Returns false if any write so far has failed
+    bool flush();
+
+    Writer& operator<<(std::string_view text) { write(text); return *this; }
+    Writer& operator<<(double value)          { write(value); return *this; }
+
+    template <std::integral T>
+    Writer& operator<<(T value) { write(value); return *this; }
+
+  private:
+    void writeAll(const char* data, std::size_t size);
+
+    int               m_fd     { 1 };
+    std::vector<char> m_buffer { };
+    std::size_t       m_used   { 0 };
+    bool              m_failed { false };
+  };
+
+  class Reader {
+  public:
+    // `tied` (if any) is flushed before every blocking read
+    explicit Reader(int fd = 0, Writer* tied = nullptr);
+    ~Reader();
+
+    Reader(const Reader&) = delete;
+    Reader& operator=(const Reader&) = delete;
+
+    // Each read skips leading whitespace and returns false at end of input
+    // or when the token is not a valid value (which also sets the fail state)
+    template <std::integral T>
+    bool read(T& value) {
+      if constexpr (std::same_as<T, char>) {
+        return readChar(value);
+      }
+
+      else {
+        if (!skipWhitespace())
+          return check(false);
+
+        // Fast path: the whole token is already in the buffer
+        if (const int parsed { parseInteger(value) }; parsed >= 0)
+          return check(parsed == 1);
+
+        const std::string_view t { token() };
+        const auto [end, ec] { std::from_chars(t.data(), t.data() + t.size(), value) };
+
+        return check(!t.empty() && ec == std::errc { } && end == t.data() + t.size());
+      }
+    }
+
+    bool read(double& value);
+    bool read(std::string& word);
+    bool readChar(char& c);
+
+    // Rest of the current line without the '\n' (like std::getline)
+    bool readLine(std::string& line);
+
+    // Returns false at end of input
+    bool skipWhitespace();
+
+    // Bytes before the next unread one, counted from where this reader
+    // started (from the start of the file, for a mapped one)
+    std::uint64_t offset() const { return m_dropped + m_pos; }
+
+    // Next whitespace-separated token; empty at end of input. The view is
+    // valid until the next call.
+    std::string_view token();
+
+    // As many whole lines as fit in maxBytes (more if one line is longer),
+    // '\n' included; the last line of the input may lack it. Empty at end
+    // of input. The view is valid until the next call.
+    std::string_view lines(std::size_t maxBytes = 1 << 20);
+
+    template <typename T>
+    Reader& operator>>(T& value) {
+      read(value);
+      return *this;
+    }
+
+    explicit operator bool() const { return !m_failed; }
+
+  private:
+    static bool isSpace(char c) { return c == ' ' || (c >= '\t' && c <= '\r'); }
+
+    // IntParse for int32/int64, otherwise a digit loop with overflow checks.
+    // Returns 1 on success, 0 on a bad token (consumed), or -1 if the token
+    // may continue past the buffer.
+    template <std::integral T>
+    int parseInteger(T& value) {
+      const char* p   { m_data + m_pos };
+      const char* end { m_data + m_end };
+      bool ok         { false };
+
+      if constexpr (std::is_signed_v<T> && (sizeof(T) == 4 || sizeof(T) == 8)) {
+        const IntParse::Result result { IntParse::parse(p, end, value) };
+
+        if (result.ptr == end && !m_eof)
+          return -1;
+
+        // Anything glued to the digits makes the whole token invalid
+        p  = result.ptr;
+        ok = result && (p == end || isSpace(*p));
+      }
+
+      else {
+        using U = std::make_unsigned_t<T>;
+        bool negative { false };
+
+        if (*p == '-' || *p == '+') {
+          negative = *p == '-';
+          ++p;
+        }
+
+        const char* digits { p };
+        U    magnitude { 0 };
+        bool overflow  { false };
+
+        while (p < end && static_cast<unsigned char>(*p - '0') < 10) {
+          overflow |= __builtin_mul_overflow(magnitude, U { 10 }, &magnitude);
+          overflow |= __builtin_add_overflow(magnitude, static_cast<U>(*p - '0'), &magnitude);
+          ++p;
+        }
+
+        if (p == end && !m_eof)
+          return -1;
+
+        ok = p > digits && (p == end || isSpace(*p)) && !overflow;
+
+        if constexpr (std::is_signed_v<T>) {
+          const U limit { static_cast<U>(static_cast<U>(std::numeric_limits<T>::max()) + negative) };
+          ok = ok && magnitude <= limit;
+          value = static_cast<T>(negative ? U { 0 } - magnitude : magnitude);
+        }
+
+        else {
+          ok = ok && (!negative || magnitude == 0);
+          value = static_cast<T>(magnitude);
+        }
+      }
+
+      while (p < end && !isSpace(*p))
+        ++p;
+
+      m_pos = static_cast<std::size_t>(p - m_data);
+      return ok;
+    }
+
+    bool refill();
+    bool check(bool ok) { m_failed = m_failed || !ok; return ok; }
+
+    int               m_fd      { 0 };
+    Writer*           m_tied    { nullptr };
+    const char*       m_data    { nullptr };
+    std::size_t       m_pos     { 0 };
+    std::size_t       m_end     { 0 };
+    std::uint64_t     m_dropped { 0 };       // bytes refill() moved out of the buffer
+    std::vector<char> m_buffer  { };
+    void*             m_map     { nullptr }; // whole input, when it is a regular file
+    bool              m_eof     { false };
+    bool              m_failed  { false };
+  };
+}
@@ -0,0 +1,515 @@
+#include "float_parse.h"
+
+#include <array>
+#include <bit>
+#include <charconv>
+#include <cstdint>
+#include <limits>
+#include <string>
+
+namespace FloatParse {
+  namespace {
+    template <typename T>
+    struct Format;
+
+    template <>
+    struct Format<double> {
+      using Bits = std::uint64_t;
+
+      static constexpr int mantissaBits      { 52 };
+      static constexpr int minimumExponent   { -1023 };
+      static constexpr int infinitePower     { 0x7FF };
+      static constexpr int minRoundToEven    { -4 };   // 5^-q fits in 64 bits at most this far
+      static constexpr int maxRoundToEven    { 23 };
+      static constexpr int smallestPower     { -342 }; // below this, even 10^19 * 10^q rounds to 0
+      static constexpr int largestPower      { 308 };  // above this, even 1 * 10^q is infinite
+      static constexpr int maxExactPower     { 22 };   // 10^22 is the last power of ten a double holds exactly
+
+      static constexpr double exactPowers[maxExactPower + 1] {
+        1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+        1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+      };
+    };
+
+    template <>
+    struct Format<float> {
+      using Bits = std::uint32_t;
+
+      static constexpr int mantissaBits      { 23 };
+      static constexpr int minimumExponent   { -127 };
+      static constexpr int infinitePower     { 0xFF };
+      static constexpr int minRoundToEven    { -17 };
+      static constexpr int maxRoundToEven    { 10 };
+      static constexpr int smallestPower     { -65 };
+      static constexpr int largestPower      { 38 };
+      static constexpr int maxExactPower     { 10 };
+
+      static constexpr float exactPowers[maxExactPower + 1] {
+        1e0f, 1e1f, 1e2f, 1e3f, 1e4f, 1e5f, 1e6f, 1e7f, 1e8f, 1e9f, 1e10f
+      };
+    };
+
+    constexpr int smallestPower { Format<double>::smallestPower };
+    constexpr int largestPower  { Format<double>::largestPower };
+    constexpr int maxDigits     { 19 }; // any 19 digits fit in a uint64_t
+
+    struct Power128 {
+      std::uint64_t high { };
+      std::uint64_t low  { };
+    };
+
+    using PowerTable = std::array<Power128, largestPower - smallestPower + 1>;
+
+    // Little-endian 32-bit limbs: just enough arithmetic to build the table
+    using Limbs = std::vector<std::uint32_t>;
+
+    void trim(Limbs& n) {
+      while (n.size() > 1 && n.back() == 0)
+        n.pop_back();
+    }
+
+    void multiplySmall(Limbs& n, std::uint32_t factor) {
+      std::uint64_t carry { 0 };
+
+      for (std::uint32_t& limb : n) {
+        carry += static_cast<std::uint64_t>(limb) * factor;
+        limb   = static_cast<std::uint32_t>(carry);
+        carry >>= 32;
+      }
+
+      if (carry)
+        n.push_back(static_cast<std::uint32_t>(carry));
+    }
+
+    void divideSmall(Limbs& n, std::uint32_t divisor) {
+      std::uint64_t remainder { 0 };
+
+      for (std::size_t i { n.size() }; i-- > 0; ) {
+        remainder = (remainder << 32) | n[i];
+        n[i]      = static_cast<std::uint32_t>(remainder / divisor);
+        remainder %= divisor;
+      }
+
+      trim(n);
+    }
+
+    void addOne(Limbs& n) {
+      for (std::uint32_t& limb : n)
+        if (++limb != 0)
+          return;
+
+      n.push_back(1);
+    }
+
+    Limbs shiftRight(const Limbs& n, int shift) {
+      const auto words { static_cast<std::size_t>(shift / 32) };
+      const int  bits  { shift % 32 };
+      Limbs out { };
+
+      for (std::size_t i { words }; i < n.size(); ++i) {
+        std::uint64_t part { n[i] >> bits };
+
+        if (bits && i + 1 < n.size())
+          part |= static_cast<std::uint64_t>(n[i + 1]) << (32 - bits);
+
+        out.push_back(static_cast<std::uint32_t>(part));
+      }
+
+      if (out.empty())
+        out.push_back(0);
+
+      trim(out);
+      return out;
+    }
+
+    int bitLength(const Limbs& n) {
+      return static_cast<int>(32 * (n.size() - 1)) + std::bit_width(n.back());
+    }
+
+    // The 128 most significant bits of n (shifted up if n is shorter)
+    Power128 top128(const Limbs& n) {
+      const int length { bitLength(n) };
+      unsigned __int128 top { 0 };
+
+      for (int i { 0 }; i < 128; ++i) {
+        const int bit { length - 128 + i };
+
+        if (bit >= 0 && (n[static_cast<std::size_t>(bit / 32)] >> (bit % 32) & 1))
+          top |= static_cast<unsigned __int128>(1) << i;
+      }
+
+      return Power128 { static_cast<std::uint64_t>(top >> 64), static_cast<std::uint64_t>(top) };
+    }
+
+    // 128-bit approximations of 5^q for every q the parser can meet, built
+    // once on first use (less than a millisecond):
+    //
+    //   q >= 0   5^q truncated to its top 128 bits
+    //   q <  0   floor(2^b / 5^-q) + 1, truncated, with b large enough that
+    //            the quotient has at least 128 bits
+    //
+    // Since floor(floor(x / 5) / 5) == floor(x / 25), dividing one big 2^B by
+    // 5 over and over yields every floor(2^B / 5^n) exactly, and
+    // floor(2^b / 5^n) is that shifted down by B - b bits.
+    const PowerTable& powersOf5() {
+      static const PowerTable table { [] {
+        PowerTable powers { };
+        Limbs five { 1 };
+
+        for (int q { 0 }; q <= largestPower; ++q) {
+          powers[static_cast<std::size_t>(q - smallestPower)] = top128(five);
+          multiplySmall(five, 5);
+        }
+
+        constexpr int bigShift { 1800 }; // more than any b below
+        Limbs reciprocal(bigShift / 32 + 1, 0);
+        reciprocal.back() = std::uint32_t { 1 } << (bigShift % 32);
+        five = Limbs { 1 };
+
+        for (int n { 1 }; n <= -smallestPower; ++n) {
+          divideSmall(reciprocal, 5);
+          multiplySmall(five, 5);
+
+          const int z { bitLength(five) };
+          const int b { n <= 27 ? z + 127 : 2 * z + 128 };
+
+          Limbs quotient { shiftRight(reciprocal, bigShift - b) };
+          addOne(quotient);
+          powers[static_cast<std::size_t>(-n - smallestPower)] = top128(quotient);
+        }
+
+        return powers;
+      }() };
+
+      return table;
+    }
+
+    struct Product {
+      std::uint64_t high { };
+      std::uint64_t low  { };
+    };
+
+    Product multiply(std::uint64_t a, std::uint64_t b) {
+      const unsigned __int128 full { static_cast<unsigned __int128>(a) * b };
+      return Product { static_cast<std::uint64_t>(full >> 64), static_cast<std::uint64_t>(full) };
+    }
+
+    // w * 5^q, exact in the `precision` + 1 bits that decide the rounding.
+    // The second multiply is only needed when those bits might still carry.
+    template <int precision>
+    Product approximateProduct(std::int64_t q, std::uint64_t w) {
+      const Power128& power { powersOf5()[static_cast<std::size_t>(q - smallestPower)] };
+      Product first { multiply(w, power.high) };
+
+      constexpr std::uint64_t mask { ~std::uint64_t { 0 } >> precision };
+
+      if ((first.high & mask) == mask) {
+        const Product second { multiply(w, power.low) };
+        first.low += second.high;
+
+        if (second.high > first.low)
+          ++first.high;
+      }
+
+      return first;
+    }
+
+    // Biased exponent (power2) and mantissa without the implicit bit
+    struct Adjusted {
+      std::uint64_t mantissa { 0 };
+      int           power2   { 0 };
+
+      bool operator==(const Adjusted&) const = default;
+    };
+
+    // floor(log2(10^q)) + 63, for |q| small enough
+    int binaryExponent(std::int64_t q) {
+      return static_cast<int>(((152170 + 65536) * q) >> 16) + 63;
+    }
+
+    // Eisel-Lemire: the correctly rounded w * 10^q, for w != 0
+    template <typename T>
+    Adjusted eiselLemire(std::int64_t q, std::uint64_t w) {
+      using F = Format<T>;
+
+      if (q < F::smallestPower)
+        return Adjusted { 0, 0 };
+
+      if (q > F::largestPower)
+        return Adjusted { 0, F::infinitePower };
+
+      const int leadingZeros { std::countl_zero(w) };
+      w <<= leadingZeros;
+
+      const Product product { approximateProduct<F::mantissaBits + 3>(q, w) };
+      const int upperBit { static_cast<int>(product.high >> 63) };
+      const int shift    { upperBit + 64 - F::mantissaBits - 3 };
+
+      Adjusted answer { product.high >> shift, binaryExponent(q) + upperBit - leadingZeros - F::minimumExponent };
+
+      // Subnormal: shift the rest of the way, then round
+      if (answer.power2 <= 0) {
+        if (-answer.power2 + 1 >= 64)
+          return Adjusted { 0, 0 };
+
+        answer.mantissa >>= -answer.power2 + 1;
+        answer.mantissa  += answer.mantissa & 1;
+        answer.mantissa >>= 1;
+        answer.power2     = answer.mantissa < (std::uint64_t { 1 } << F::mantissaBits) ? 0 : 1;
+
+        return answer;
+      }
+
+      // Exactly halfway between two values (only possible for small |q|):
+      // round to even instead of up
+      if (product.low <= 1 && q >= F::minRoundToEven && q <= F::maxRoundToEven
+          && (answer.mantissa & 3) == 1 && (answer.mantissa << shift) == product.high)
+        answer.mantissa &= ~std::uint64_t { 1 };
+
+      answer.mantissa += answer.mantissa & 1;
+      answer.mantissa >>= 1;
+
+      if (answer.mantissa >= (std::uint64_t { 2 } << F::mantissaBits)) {
+        answer.mantissa = std::uint64_t { 1 } << F::mantissaBits;
+        ++answer.power2;
+      }
+
+      answer.mantissa &= ~(std::uint64_t { 1 } << F::mantissaBits);
+
+      if (answer.power2 >= F::infinitePower)
+        return Adjusted { 0, F::infinitePower };
+
+      return answer;
+    }
+
+    template <typename T>
+    T assemble(Adjusted adjusted, bool negative) {
+      using Bits = typename Format<T>::Bits;
+
+      const Bits bits { static_cast<Bits>(adjusted.mantissa
+                                          | static_cast<std::uint64_t>(adjusted.power2) << Format<T>::mantissaBits
+                                          | static_cast<std::uint64_t>(negative) << (8 * sizeof(T) - 1)) };
+
+      return std::bit_cast<T>(bits);
+    }
+
+    bool isDigit(char c) {
+      return static_cast<unsigned char>(c - '0') < 10;
+    }
+
+    // The number is w * 10^q; `truncated` if digits beyond the 19th were
+    // not all zero
+    struct Decimal {
+      std::uint64_t w         { 0 };
+      std::int64_t  q         { 0 };
+      int           kept      { 0 };
+      bool          negative  { false };
+      bool          truncated { false };
+      bool          anyDigit  { false };
+
+      void add(char c, bool fraction) {
+        const auto digit { static_cast<std::uint64_t>(c - '0') };
+
+        if (kept < maxDigits) [[likely]] {
+          w     = 10 * w + digit;
+          kept += w != 0; // leading zeros are not kept
+          q    -= fraction;
+        }
+
+        else {
+          q += !fraction;
+          truncated |= digit != 0;
+        }
+      }
+    };
+
+    // A ' continues a number only between two digits, as in C++ literals
+    bool separatorAt(const char* p, const char* first, const char* last) {
+      return *p == '\'' && p > first && isDigit(p[-1]) && p + 1 < last && isDigit(p[1]);
+    }
+
+    // Digits (and separators) of the integer or fraction part
+    const char* scanDigits(const char* p, const char* last, Decimal& decimal, bool fraction) {
+      const char* start { p };
+
+      while (p < last) {
+        // Eight digits at once while they all fit in w
+        while (decimal.kept > 0 && decimal.kept + 8 <= maxDigits && last - p >= 8) {
+          const std::uint64_t word { IntParse::load8(p) };
+
+          if (IntParse::nonDigitBytes(word) != 0)
+            break;
+
+          decimal.w     = decimal.w * 100'000'000 + IntParse::eightDigits(word);
+          decimal.kept += 8;
+          decimal.q    -= fraction ? 8 : 0;
+          p            += 8;
+        }
+
+        if (p < last && isDigit(*p))
+          decimal.add(*p++, fraction);
+        else if (p < last && separatorAt(p, start, last))
+          ++p;
+        else
+          break;
+      }
+
+      decimal.anyDigit |= p > start;
+      return p;
+    }
+
+    // Optional exponent; the 'e' is left alone if no digits follow it
+    const char* scanExponent(const char* p, const char* last, Decimal& decimal) {
+      if (p == last || (*p != 'e' && *p != 'E'))
+        return p;
+
+      const char* e { p + 1 };
+      bool negative { false };
+
+      if (e < last && (*e == '-' || *e == '+')) {
+        negative = *e == '-';
+        ++e;
+      }
+
+      if (e == last || !isDigit(*e))
+        return p;
+
+      const char* start { e };
+      std::int64_t exponent { 0 };
+
+      for (; e < last && (isDigit(*e) || separatorAt(e, start, last)); ++e)
+        if (*e != '\'' && exponent < 1'000'000)
+          exponent = 10 * exponent + (*e - '0');
+
+      decimal.q += negative ? -exponent : exponent;
+      return e;
+    }
+
+    // std::from_chars on the text without separators or a leading '+'. Out
+    // of range, from_chars leaves value alone: w * 10^q with 19 digits in w
+    // can only overflow for q > 0 and only underflow for q < 0, so that
+    // picks between +-infinity and +-0.
+    template <typename T>
+    void parseSlow(const char* first, const char* end, const Decimal& decimal, T& value) {
+      std::string text { };
+
+      for (const char* p { first }; p < end; ++p)
+        if (*p != '\'' && !(p == first && *p == '+'))
+          text += *p;
+
+      if (std::from_chars(text.data(), text.data() + text.size(), value).ec == std::errc::result_out_of_range) {
+        value = decimal.q > 0 ? std::numeric_limits<T>::infinity() : T { 0 };
+        value = decimal.negative ? -value : value;
+      }
+    }
+
+    template <typename T>
+    Result parseFloat(const char* first, const char* last, T& value) {
+      using F = Format<T>;
+
+      Decimal decimal { };
+      const char* p { first };
+
+      if (p < last && (*p == '-' || *p == '+')) {
+        decimal.negative = *p == '-';
+        ++p;
+      }
+
+      p = scanDigits(p, last, decimal, false);
+
+      if (p < last && *p == '.')
+        p = scanDigits(p + 1, last, decimal, true);
+
+      // inf, nan, or not a number at all
+      if (!decimal.anyDigit) {
+        const auto [end, ec] { std::from_chars(first, last, value) };
+
+        if (ec == std::errc { })
+          return Result { end, Error::none };
+
+        return Result { first, Error::noDigits };
+      }
+
+      p = scanExponent(p, last, decimal);
+
+      if (decimal.w == 0) {
+        value = decimal.negative ? -T { 0 } : T { 0 };
+        return Result { p, Error::none };
+      }
+
+      // Clinger: both operands exact, so one rounding
+      if (!decimal.truncated && decimal.w <= std::uint64_t { 1 } << (F::mantissaBits + 1)
+          && decimal.q >= -F::maxExactPower && decimal.q <= F::maxExactPower) {
+        T result { static_cast<T>(decimal.w) };
+
+        if (decimal.q < 0)
+          result /= F::exactPowers[-decimal.q];
+        else
+          result *= F::exactPowers[decimal.q];
+
+        value = decimal.negative ? -result : result;
+        return Result { p, Error::none };
+      }
+
+      const Adjusted answer { eiselLemire<T>(decimal.q, decimal.w) };
+
+      // The true value lies between w and w + 1 times 10^q
+      if (decimal.truncated && !(eiselLemire<T>(decimal.q, decimal.w + 1) == answer)) {
+        parseSlow(first, p, decimal, value);
+        return Result { p, Error::none };
+      }
+
+      value = assemble<T>(answer, decimal.negative);
+      return Result { p, Error::none };
+    }
+
+    bool isColumnSeparator(char c) {
+      return c == ',' || c == ' ' || (c >= '\t' && c <= '\r');
+    }
+
+    template <typename T>
+    Result parseAll(std::string_view text, std::vector<T>& out) {
+      const char* p    { text.data() };
+      const char* last { text.data() + text.size() };
+
+      // Numbers are rarely shorter than this, so it usually allocates once
+      out.reserve(out.size() + text.size() / 8);
+
+      for (;;) {
+        while (p < last && isColumnSeparator(*p))
+          ++p;
+
+        if (p == last)
+          return Result { p, Error::none };
+
+        T value { };
+        const Result result { parseFloat(p, last, value) };
+
+        if (!result)
+          return result;
+
+        if (result.ptr != last && !isColumnSeparator(*result.ptr))
+          return Result { result.ptr, Error::invalidCharacter };
+
+        out.push_back(value);
+        p = result.ptr;
+      }
+    }
+  }
+
+  Result parse(const char* first, const char* last, double& value) {
+    return parseFloat(first, last, value);
+  }
+
+  Result parse(const char* first, const char* last, float& value) {
+    return parseFloat(first, last, value);
+  }
+
+  Result parseColumn(std::string_view text, std::vector<double>& out) {
+    return parseAll(text, out);
+  }
+
+  Result parseColumn(std::string_view text, std::vector<float>& out) {
+    return parseAll(text, out);
+  }
+}
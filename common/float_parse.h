@@ -0,0 +1,45 @@
+// +--------------------------------------------+
+// |       FAST DECIMAL -> FLOATING POINT       |
+// +--------------------------------------------+
+//
+// Correctly rounded parsing of literals like 6.02e23, 1.6e-19 or
+// 1'000'000.5 into double or float, much faster than std::cin >> double:
+//
+//   1. Up to 19 significant digits are gathered into a 64-bit integer w
+//      (8 at a time with IntParse's SWAR helpers), so the value is
+//      w * 10^q.
+//   2. Clinger's fast path: if w and 10^|q| are both exact in the target
+//      type, one multiply or divide gives the correctly rounded result.
+//   3. Otherwise Eisel-Lemire: w times a 128-bit truncation of 5^q gives
+//      enough of the exact product to round it, with the power of two
+//      applied to the exponent directly.
+//   4. With more than 19 significant digits, w is truncated; if w and w + 1
+//      round to different values, std::from_chars settles it (the slow
+//      path, rarely taken).
+//
+// Digit separators (') are accepted between two digits, as in C++
+// literals. inf and nan are handed to std::from_chars. Values too large
+// become +-infinity and values too small +-0, like IEEE arithmetic.
+
+#pragma once
+
+#include "int_parse.h"
+
+#include <string_view>
+#include <vector>
+
+namespace FloatParse {
+  using IntParse::Error;
+  using IntParse::Result;
+
+  // Stops at the first character that cannot continue the number; Result
+  // says where, as with IntParse::parse
+  Result parse(const char* first, const char* last, double& value);
+  Result parse(const char* first, const char* last, float& value);
+
+  // Bulk column: every number in `text`, separated by whitespace or commas,
+  // appended to `out`. Stops at the first bad one and returns its Result,
+  // whose ptr is the offending character.
+  Result parseColumn(std::string_view text, std::vector<double>& out);
+  Result parseColumn(std::string_view text, std::vector<float>& out);
+}
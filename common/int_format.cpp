@@ -0,0 +1,207 @@
+#include "int_format.h"
+
+#include <bit>
+#include <cstring>
+
+// INT_FORMAT_SCALAR forces the portable path, so it can be tested on x86
+#if defined(__SSE2__) && !defined(INT_FORMAT_SCALAR)
+  #define INT_FORMAT_SSE2
+  #include <emmintrin.h>
+#endif
+
+namespace IntFormat {
+  namespace {
+    constexpr std::uint64_t powersOf10[20] {
+      1ull, 10ull, 100ull, 1'000ull, 10'000ull, 100'000ull, 1'000'000ull, 10'000'000ull,
+      100'000'000ull, 1'000'000'000ull, 10'000'000'000ull, 100'000'000'000ull,
+      1'000'000'000'000ull, 10'000'000'000'000ull, 100'000'000'000'000ull,
+      1'000'000'000'000'000ull, 10'000'000'000'000'000ull, 100'000'000'000'000'000ull,
+      1'000'000'000'000'000'000ull, 10'000'000'000'000'000'000ull
+    };
+
+    constexpr std::uint32_t tenTo8  { 100'000'000 };
+    constexpr std::uint64_t tenTo16 { 10'000'000'000'000'000ull };
+
+    struct PairTable {
+      char digits[200];
+
+      constexpr PairTable() : digits { } {
+        for (int i { 0 }; i < 100; ++i) {
+          digits[2 * i]     = static_cast<char>('0' + i / 10);
+          digits[2 * i + 1] = static_cast<char>('0' + i % 10);
+        }
+      }
+    };
+
+    constexpr PairTable pairs { };
+
+    // Digit words are built and trimmed as little-endian integers
+    static_assert(std::endian::native == std::endian::little);
+
+#ifdef INT_FORMAT_SSE2
+    // value < 10^8 -> eight 16-bit digits, most significant first.
+    // abcdefgh splits into abcd / efgh; each lane then holds abcd (or efgh)
+    // divided by 1000, 100, 10, 1 (multiply-high by scaled reciprocals),
+    // and subtracting 10x the neighbouring lane leaves one digit per lane.
+    __m128i eightDigits(std::uint32_t value) {
+      const __m128i abcdefgh { _mm_cvtsi32_si128(static_cast<int>(value)) };
+      const __m128i abcd     { _mm_srli_epi64(_mm_mul_epu32(abcdefgh, _mm_set1_epi32(static_cast<int>(0xD1B71759u))), 45) };
+      const __m128i efgh     { _mm_sub_epi32(abcdefgh, _mm_mul_epu32(abcd, _mm_set1_epi32(10'000))) };
+
+      const __m128i v1 { _mm_unpacklo_epi16(abcd, efgh) };
+      const __m128i v2 { _mm_slli_epi64(v1, 2) };
+      const __m128i v3 { _mm_unpacklo_epi32(_mm_unpacklo_epi16(v2, v2), _mm_unpacklo_epi16(v2, v2)) };
+
+      const __m128i divide { _mm_setr_epi16(8389, 5243, 13108, -32768, 8389, 5243, 13108, -32768) };
+      const __m128i shift  { _mm_setr_epi16(1 << 7, 1 << 11, 1 << 13, -32768, 1 << 7, 1 << 11, 1 << 13, -32768) };
+
+      const __m128i prefixes { _mm_mulhi_epu16(_mm_mulhi_epu16(v3, divide), shift) }; // a, ab, abc, abcd, e, ...
+      const __m128i tens     { _mm_slli_epi64(_mm_mullo_epi16(prefixes, _mm_set1_epi16(10)), 16) };
+
+      return _mm_sub_epi16(prefixes, tens);
+    }
+
+    // Eight ASCII digits (leading zeros included) in a little-endian word,
+    // so the first digit is the low byte
+    std::uint64_t eightAscii(std::uint32_t value) {
+      const __m128i digits { eightDigits(value) };
+      return static_cast<std::uint64_t>(_mm_cvtsi128_si64(_mm_add_epi8(_mm_packus_epi16(digits, digits), _mm_set1_epi8('0'))));
+    }
+
+    void writeSixteen(char* out, std::uint32_t high, std::uint32_t low) {
+      const __m128i ascii { _mm_add_epi8(_mm_packus_epi16(eightDigits(high), eightDigits(low)), _mm_set1_epi8('0')) };
+
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(out), ascii);
+    }
+#else
+    // Writes exactly `count` digits of value, ending at out + count, with
+    // leading zeros
+    void writeDigits(char* out, std::uint32_t value, int count) {
+      char* p { out + count };
+
+      while (value >= 100) {
+        const std::uint32_t q { value / 100 };
+        p -= 2;
+        std::memcpy(p, pairs.digits + 2 * (value - 100 * q), 2);
+        value = q;
+      }
+
+      if (value >= 10) {
+        p -= 2;
+        std::memcpy(p, pairs.digits + 2 * value, 2);
+      }
+
+      else {
+        *--p = static_cast<char>('0' + value);
+      }
+
+      while (p > out)
+        *--p = '0';
+    }
+
+    std::uint64_t eightAscii(std::uint32_t value) {
+      char digits[8];
+      writeDigits(digits, value, 8);
+
+      std::uint64_t word { };
+      std::memcpy(&word, digits, sizeof(word));
+
+      return word;
+    }
+
+    void writeSixteen(char* out, std::uint32_t high, std::uint32_t low) {
+      writeDigits(out, high, 8);
+      writeDigits(out + 8, low, 8);
+    }
+#endif
+
+    void writeEight(char* out, std::uint32_t value) {
+      const std::uint64_t word { eightAscii(value) };
+      std::memcpy(out, &word, sizeof(word));
+    }
+
+    // value < 10^8. Always stores 8 bytes: the digits, then filler that the
+    // caller's next write overwrites (hence maxChars bytes of room).
+    char* writeShort(char* out, std::uint32_t value) {
+      if (value < 100) {
+        if (value < 10) {
+          *out = static_cast<char>('0' + value);
+          return out + 1;
+        }
+
+        std::memcpy(out, pairs.digits + 2 * value, 2);
+        return out + 2;
+      }
+
+      // Dropping the low bytes drops the leading zeros (little endian)
+      const int count { digitCount(value) };
+      const std::uint64_t word { eightAscii(value) >> (8 * (8 - count)) };
+      std::memcpy(out, &word, sizeof(word));
+
+      return out + count;
+    }
+
+    template <typename T>
+    std::size_t writeSeparated(std::span<const T> values, char separator, char* out) {
+      char* p { out };
+
+      for (const T value : values) {
+        p = write(p, value);
+        *p++ = separator;
+      }
+
+      return static_cast<std::size_t>(p - out);
+    }
+  }
+
+  int digitCount(std::uint64_t value) {
+    // floor(log10(2^bits)) is within one of the answer; the table settles it
+    const int guess { ((64 - __builtin_clzll(value | 1)) * 1233) >> 12 };
+    return guess + 1 - ((value | 1) < powersOf10[guess]);
+  }
+
+  char* writeUnsigned(char* out, std::uint32_t value) {
+    if (value < tenTo8)
+      return writeShort(out, value);
+
+    // At most 42 above the low 8 digits
+    const std::uint32_t high { value / tenTo8 };
+    char* p { writeShort(out, high) };
+    writeEight(p, value - high * tenTo8);
+
+    return p + 8;
+  }
+
+  char* writeUnsigned(char* out, std::uint64_t value) {
+    if (value <= 0xFFFF'FFFFu)
+      return writeUnsigned(out, static_cast<std::uint32_t>(value));
+
+    if (value < tenTo16) {
+      const auto high { static_cast<std::uint32_t>(value / tenTo8) };
+      char* p { writeShort(out, high) };
+      writeEight(p, static_cast<std::uint32_t>(value - std::uint64_t { high } * tenTo8));
+
+      return p + 8;
+    }
+
+    const auto top  { static_cast<std::uint32_t>(value / tenTo16) }; // at most 1844
+    const std::uint64_t rest { value - std::uint64_t { top } * tenTo16 };
+    const auto high { static_cast<std::uint32_t>(rest / tenTo8) };
+    char* p { writeShort(out, top) };
+    writeSixteen(p, high, static_cast<std::uint32_t>(rest - std::uint64_t { high } * tenTo8));
+
+    return p + 16;
+  }
+
+  std::size_t writeAll(std::span<const std::int32_t> values, char separator, char* out) {
+    return writeSeparated(values, separator, out);
+  }
+
+  std::size_t writeAll(std::span<const std::int64_t> values, char separator, char* out) {
+    return writeSeparated(values, separator, out);
+  }
+
+  std::size_t writeAll(std::span<const std::uint64_t> values, char separator, char* out) {
+    return writeSeparated(values, separator, out);
+  }
+}
@@ -0,0 +1,69 @@
+// +--------------------------------------------+
+// |       FAST INTEGER -> DECIMAL FORMATTING   |
+// +--------------------------------------------+
+//
+// operator<<(int) goes through locales, facets and a virtual call per value.
+// This writes the digits straight into a char buffer:
+//
+//   - The digit count comes first, from the bit length (log10(2) ~ 1233/4096)
+//     and one table compare, so digits are written exactly where they belong.
+//   - Values are split into 8-digit blocks, and SSE2 turns each block into
+//     8 ASCII digits at once with multiply-high by reciprocals (no division).
+//     The leading block's zeros are shifted out of the 64-bit word before
+//     it is stored; one- and two-digit values come from a "00".."99" table.
+//     Without SSE2 (or built with -DINT_FORMAT_SCALAR) each block is written
+//     two digits at a time from that table instead.
+//
+// The bulk API formats a whole array, separated, into one buffer.
+
+#pragma once
+
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+
+namespace IntFormat {
+  // Longest output: "18446744073709551615" and "-9223372036854775808"
+  inline constexpr std::size_t maxChars { 20 };
+
+  // Number of decimal digits (1 for 0)
+  int digitCount(std::uint64_t value);
+
+  char* writeUnsigned(char* out, std::uint32_t value);
+  char* writeUnsigned(char* out, std::uint64_t value);
+
+  // Writes value at out (out needs maxChars bytes, no terminator is added)
+  // and returns one past the last digit
+  template <std::integral T>
+  char* write(char* out, T value) {
+    using U = std::conditional_t<(sizeof(T) <= 4), std::uint32_t, std::uint64_t>;
+
+    if constexpr (std::is_signed_v<T>) {
+      if (value < 0) {
+        *out++ = '-';
+        return writeUnsigned(out, static_cast<U>(U { 0 } - static_cast<U>(value)));
+      }
+    }
+
+    return writeUnsigned(out, static_cast<U>(value));
+  }
+
+  // Bytes needed to format `count` values with separators
+  constexpr std::size_t bulkCapacity(std::size_t count) { return count * (maxChars + 1); }
+
+  // Every value followed by `separator`, into out (bulkCapacity bytes);
+  // returns the number of bytes written
+  std::size_t writeAll(std::span<const std::int32_t>  values, char separator, char* out);
+  std::size_t writeAll(std::span<const std::int64_t>  values, char separator, char* out);
+  std::size_t writeAll(std::span<const std::uint64_t> values, char separator, char* out);
+
+  // Same, appended to a string
+  template <std::integral T>
+  void appendAll(std::span<const T> values, char separator, std::string& out) {
+    const std::size_t used { out.size() };
+    out.resize(used + bulkCapacity(values.size()));
+    out.resize(used + writeAll(values, separator, out.data() + used));
+  }
+}
@@ -0,0 +1,182 @@
+#include "int_parse.h"
+
+#include <limits>
+
+#ifdef __SSE2__
+  #include <emmintrin.h>
+#endif
+
+namespace IntParse {
+  namespace {
+    constexpr std::uint64_t powersOf10[9] { 1, 10, 100, 1'000, 10'000, 100'000, 1'000'000, 10'000'000, 100'000'000 };
+
+    // Number of digits at the front of the 16 bytes at p (16 if all are)
+    unsigned leadingDigits16(const char* p) {
+#ifdef __SSE2__
+      const __m128i bytes  { _mm_loadu_si128(reinterpret_cast<const __m128i*>(p)) };
+      const __m128i digits { _mm_and_si128(_mm_cmpgt_epi8(bytes, _mm_set1_epi8('0' - 1)),
+                                           _mm_cmplt_epi8(bytes, _mm_set1_epi8('9' + 1))) };
+      const unsigned others { ~static_cast<unsigned>(_mm_movemask_epi8(digits)) };
+
+      return static_cast<unsigned>(__builtin_ctz(others | 0x1'0000u));
+#else
+      if (const std::uint64_t others { nonDigitBytes(load8(p)) })
+        return static_cast<unsigned>(__builtin_ctzll(others)) / 8;
+
+      if (const std::uint64_t others { nonDigitBytes(load8(p + 8)) })
+        return 8 + static_cast<unsigned>(__builtin_ctzll(others)) / 8;
+
+      return 16;
+#endif
+    }
+
+    // Length of the run of digits starting at p
+    std::size_t countDigits(const char* p, const char* last) {
+      const char* start { p };
+
+      while (last - p >= 16) {
+        if (const unsigned n { leadingDigits16(p) }; n < 16)
+          return static_cast<std::size_t>(p - start) + n;
+
+        p += 16;
+      }
+
+      while (last - p >= 8) {
+        if (const std::uint64_t others { nonDigitBytes(load8(p)) })
+          return static_cast<std::size_t>(p - start) + static_cast<std::size_t>(__builtin_ctzll(others) / 8);
+
+        p += 8;
+      }
+
+      while (p < last && static_cast<unsigned char>(*p - '0') < 10)
+        ++p;
+
+      return static_cast<std::size_t>(p - start);
+    }
+
+    // Value of n <= 19 digits at p
+    std::uint64_t digitsValue(const char* p, const char* last, std::size_t n) {
+      std::uint64_t value { 0 };
+
+      for (; n >= 8; n -= 8, p += 8)
+        value = value * powersOf10[8] + eightDigits(load8(p));
+
+      if (n == 0)
+        return value;
+
+      // Shifting the partial block up fills its front with zero digits
+      if (last - p >= 8)
+        return value * powersOf10[n] + eightDigits(load8(p) << (8 * (8 - n)));
+
+      for (; n > 0; --n)
+        value = 10 * value + static_cast<std::uint64_t>(*p++ - '0');
+
+      return value;
+    }
+
+    // The common case: 1..15 digits with at least 16 readable bytes. The
+    // digits are shifted to the top of a 16-byte block (leading zeros
+    // included, since at most 15 digits always fit), so there are no
+    // per-length branches at all. With only 8 readable bytes the same
+    // works for 1..7 digits in one word.
+    bool parseShort(const char* p, const char* last, const char*& end, std::uint64_t& magnitude) {
+      if (last - p >= 16) {
+        const unsigned n { leadingDigits16(p) };
+
+        if (n == 0 || n == 16)
+          return false;
+
+        unsigned __int128 block { (static_cast<unsigned __int128>(load8(p + 8)) << 64) | load8(p) };
+        block <<= 8 * (16 - n);
+
+        magnitude = eightDigits(static_cast<std::uint64_t>(block)) * powersOf10[8]
+                  + eightDigits(static_cast<std::uint64_t>(block >> 64));
+        end = p + n;
+
+        return true;
+      }
+
+      if (last - p >= 8) {
+        const std::uint64_t word   { load8(p) };
+        const std::uint64_t others { nonDigitBytes(word) };
+
+        if (others == 0 || (others & 0x80) != 0)
+          return false;
+
+        const auto n { static_cast<unsigned>(__builtin_ctzll(others)) / 8 };
+
+        magnitude = eightDigits(word << (8 * (8 - n)));
+        end = p + n;
+
+        return true;
+      }
+
+      // Fewer than 8 bytes left: at most 7 digits, which cannot overflow
+      for (end = p; end < last && static_cast<unsigned char>(*end - '0') < 10; ++end)
+        magnitude = 10 * magnitude + static_cast<std::uint64_t>(*end - '0');
+
+      return end != p;
+    }
+
+    // Shared by both widths; `maxDigits` digits always fit in a uint64_t
+    template <typename T>
+    Result parseSigned(const char* first, const char* last, T& value) {
+      using U = std::make_unsigned_t<T>;
+      constexpr std::size_t maxDigits { std::numeric_limits<T>::digits10 + 1 };
+
+      const char* p { first };
+      bool negative { false };
+
+      if (p < last && (*p == '-' || *p == '+')) {
+        negative = *p == '-';
+        ++p;
+      }
+
+      const char*   end       { p };
+      std::uint64_t magnitude { 0 };
+
+      if (!parseShort(p, last, end, magnitude)) {
+        end = p + countDigits(p, last);
+
+        if (end == p)
+          return Result { p, Error::noDigits };
+
+        // Leading zeros do not count towards overflow
+        while (p + 1 < end && *p == '0')
+          ++p;
+
+        const auto digits { static_cast<std::size_t>(end - p) };
+
+        if (digits > maxDigits)
+          return Result { end, Error::overflow };
+
+        magnitude = digitsValue(p, last, digits);
+      }
+
+      const std::uint64_t limit { static_cast<std::uint64_t>(std::numeric_limits<T>::max()) + negative };
+
+      if (magnitude > limit)
+        return Result { end, Error::overflow };
+
+      value = static_cast<T>(negative ? U { 0 } - static_cast<U>(magnitude) : static_cast<U>(magnitude));
+      return Result { end, Error::none };
+    }
+  }
+
+  Result parse(const char* first, const char* last, std::int32_t& value) {
+    return parseSigned(first, last, value);
+  }
+
+  Result parse(const char* first, const char* last, std::int64_t& value) {
+    return parseSigned(first, last, value);
+  }
+
+  const char* describe(Error error) {
+    switch (error) {
+      case Error::noDigits:         return "expected a number";
+      case Error::invalidCharacter: return "not a digit";
+      case Error::overflow:         return "number out of range";
+      default:                      return "ok";
+    }
+  }
+}
@@ -0,0 +1,112 @@
+// +--------------------------------------------+
+// |        FAST DECIMAL -> INTEGER PARSING     |
+// +--------------------------------------------+
+//
+// Parses signed 32/64-bit decimal numbers without touching one character
+// at a time:
+//
+//   - SSE2 compares 16 bytes against '0'..'9' at once (SWAR does 8 in a
+//     64-bit register when SSE2 is missing, or near the end of the input),
+//     and the first non-digit's position comes from count-trailing-zeros.
+//   - 8 digits at a time are then combined in a 64-bit register with three
+//     multiplies (10 * a + b for pairs, then 100 * .. for quads, then 10^4).
+//   - Overflow is decided from the digit count plus one compare, never by
+//     checking after each digit.
+//
+// Like std::from_chars, parse() reads an optional sign ('-' or '+') and then
+// digits, and stops at the first non-digit. parseField() and
+// parseDelimited() also say where a field stops being a number.
+//
+// The fast path needs 16 (or 8) readable bytes from the number's start, so
+// pass the end of the whole buffer rather than the end of the field when
+// you can: a 3-byte field with nothing readable after it takes the scalar
+// path, which is no faster than std::from_chars.
+
+#pragma once
+
+#include <concepts>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+
+namespace IntParse {
+  enum class Error { none, noDigits, invalidCharacter, overflow };
+
+  struct Result {
+    const char* ptr   { nullptr }; // none/overflow: past the digits; otherwise the offending character
+    Error       error { Error::none };
+
+    explicit operator bool() const { return error == Error::none; }
+  };
+
+  Result parse(const char* first, const char* last, std::int32_t& value);
+  Result parse(const char* first, const char* last, std::int64_t& value);
+
+  // Any signed integer type of 32 or 64 bits (int, long, long long, ...)
+  template <std::signed_integral T>
+    requires (sizeof(T) == 4 || sizeof(T) == 8)
+  Result parse(const char* first, const char* last, T& value) {
+    using Fixed = std::conditional_t<sizeof(T) == 4, std::int32_t, std::int64_t>;
+
+    Fixed fixed { };
+    const Result result { parse(first, last, fixed) };
+    value = static_cast<T>(fixed);
+
+    return result;
+  }
+
+  // The whole field must be a number
+  template <std::signed_integral T>
+  Result parseField(std::string_view field, T& value) {
+    const char* last { field.data() + field.size() };
+    const Result result { parse(field.data(), last, value) };
+
+    if (result.error == Error::none && result.ptr != last)
+      return Result { result.ptr, Error::invalidCharacter };
+
+    return result;
+  }
+
+  // One field of a delimited record (CSV, TSV): the number must be followed
+  // by `separator`, a line break or `last`, the end of the whole text
+  template <std::signed_integral T>
+  Result parseDelimited(const char* first, const char* last, char separator, T& value) {
+    const Result result { parse(first, last, value) };
+    const char* p { result.ptr };
+
+    if (result.error == Error::none && p != last && *p != separator && *p != '\n' && *p != '\r')
+      return Result { p, Error::invalidCharacter };
+
+    return result;
+  }
+
+  // Human-readable reason, for error messages
+  const char* describe(Error error);
+
+  // SWAR building blocks, shared with FloatParse. A word holds 8 characters,
+  // the first in the low byte.
+  inline std::uint64_t load8(const char* p) {
+    std::uint64_t word { };
+    std::memcpy(&word, p, sizeof(word));
+
+    return word;
+  }
+
+  // High bit of each byte that is not '0'..'9'
+  inline std::uint64_t nonDigitBytes(std::uint64_t word) {
+    constexpr std::uint64_t ones  { 0x0101'0101'0101'0101ull };
+    constexpr std::uint64_t highs { 0x8080'8080'8080'8080ull };
+
+    const std::uint64_t d { word ^ (ones * '0') };              // digits become 0..9
+    const std::uint64_t t { (d & ~highs) + ones * (0x80 - 10) }; // high bit if low 7 bits >= 10
+
+    return (t | d) & highs;
+  }
+
+  // Value of eight ASCII digits
+  inline std::uint64_t eightDigits(std::uint64_t word) {
+    word = ((word & 0x0F0F'0F0F'0F0F'0F0Full) * 2561) >> 8;            // pairs:  10 * a + b
+    word = ((word & 0x00FF'00FF'00FF'00FFull) * 6553601) >> 16;        // quads:  100 * ab + cd
+    return ((word & 0x0000'FFFF'0000'FFFFull) * 42949672960001) >> 32; // 10^4 * abcd + efgh
+  }
+}
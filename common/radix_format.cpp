@@ -0,0 +1,294 @@
+#include "radix_format.h"
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(__i386__)
+  #include <immintrin.h>
+  #define RADIX_X86 1
+#endif
+
+namespace RadixFormat {
+  namespace {
+    constexpr std::uint64_t ones { 0x0101'0101'0101'0101ull };
+
+    int bitsPerDigit(Radix radix) {
+      switch (radix) {
+        case Radix::binary: return 1;
+        case Radix::octal:  return 3;
+        default:            return 4;
+      }
+    }
+
+    int digitsFor(int bits, Radix radix) {
+      return (bits + bitsPerDigit(radix) - 1) / bitsPerDigit(radix);
+    }
+
+    std::size_t prefixLength(const Options& options) {
+      if (!options.prefix)
+        return 0;
+
+      return options.radix == Radix::octal ? 1 : 2;
+    }
+
+    // The 8 nibbles of v, one per byte, least significant in the low byte
+    std::uint64_t spreadNibbles(std::uint32_t v) {
+      std::uint64_t x { v };
+      x = ((x & 0xFFFF'0000ull) << 16)           | (x & 0x0000'FFFFull);
+      x = ((x & 0x0000'FF00'0000'FF00ull) << 8)  | (x & 0x0000'00FF'0000'00FFull);
+      x = ((x & 0x00F0'00F0'00F0'00F0ull) << 4)  | (x & 0x000F'000F'000F'000Full);
+      return x;
+    }
+
+    // 8 hex digits of v as they appear in memory (most significant first)
+    std::uint64_t hexWord(std::uint32_t v, bool upperCase) {
+      const std::uint64_t nibbles { spreadNibbles(v) };
+      const std::uint64_t letters { ((nibbles + ones * 6) >> 4) & ones }; // 1 where nibble >= 10
+
+      return __builtin_bswap64(nibbles + ones * '0' + letters * (upperCase ? 'A' - '0' - 10 : 'a' - '0' - 10));
+    }
+
+    // 8 binary digits of a byte as they appear in memory (bit 7 first)
+    std::uint64_t binaryWord(std::uint8_t v) {
+      // Byte i keeps only bit i, then any nonzero byte becomes 1
+      const std::uint64_t bits { (v * ones) & 0x8040'2010'0804'0201ull };
+      const std::uint64_t set  { ((bits + ones * 0x7F) >> 7) & ones };
+
+      return __builtin_bswap64(set + ones * '0');
+    }
+
+    // The `count` lowest digits of value, most significant first
+    void writeDigits(char* out, std::uint64_t value, int count, const Options& options) {
+      char digits[64];
+
+      switch (options.radix) {
+        case Radix::hex: {
+          const std::uint64_t high { hexWord(static_cast<std::uint32_t>(value >> 32), options.upperCase) };
+          const std::uint64_t low  { hexWord(static_cast<std::uint32_t>(value), options.upperCase) };
+          std::memcpy(digits,     &high, 8);
+          std::memcpy(digits + 8, &low,  8);
+          std::memcpy(out, digits + 16 - count, static_cast<std::size_t>(count));
+          break;
+        }
+
+        case Radix::binary:
+          for (int byte { 0 }; byte < 8; ++byte) {
+            const std::uint64_t word { binaryWord(static_cast<std::uint8_t>(value >> (56 - 8 * byte))) };
+            std::memcpy(digits + 8 * byte, &word, 8);
+          }
+
+          std::memcpy(out, digits + 64 - count, static_cast<std::size_t>(count));
+          break;
+
+        case Radix::octal:
+          for (int i { count }; i-- > 0; value >>= 3)
+            out[i] = static_cast<char>('0' + (value & 7));
+
+          break;
+      }
+    }
+
+    char* writePrefix(char* out, const Options& options) {
+      if (!options.prefix)
+        return out;
+
+      *out++ = '0';
+
+      if (options.radix == Radix::hex)
+        *out++ = options.upperCase ? 'X' : 'x';
+      else if (options.radix == Radix::binary)
+        *out++ = 'b';
+
+      return out;
+    }
+
+    char* writeValue(char* out, std::uint64_t value, int valueBits, const Options& options) {
+      const int count { options.fixedWidth
+                          ? digitsFor(valueBits, options.radix)
+                          : digitsFor(std::max(1, static_cast<int>(std::bit_width(value))), options.radix) };
+
+      out = writePrefix(out, options);
+
+      if (options.group <= 0 || count <= options.group) {
+        writeDigits(out, value, count, options);
+        return out + count;
+      }
+
+      char digits[64];
+      writeDigits(digits, value, count, options);
+
+      for (int i { 0 }; i < count; ++i) {
+        if (i > 0 && (count - i) % options.group == 0)
+          *out++ = options.groupSeparator;
+
+        *out++ = digits[i];
+      }
+
+      return out;
+    }
+
+    template <typename T>
+    std::size_t writeGeneric(std::span<const T> values, const Options& options, char* out) {
+      char* p { out };
+
+      for (const T v : values) {
+        p = writeValue(p, v, 8 * sizeof(T), options);
+
+        if (options.separator)
+          *p++ = options.separator;
+      }
+
+      return static_cast<std::size_t>(p - out);
+    }
+
+#ifdef RADIX_X86
+    // Where each output byte of "hh hh hh ..." comes from, for 16 input bytes
+    // (48 output bytes, three registers): a high digit, a low digit or the
+    // separator. -1 makes pshufb write zero.
+    struct SpacedHexMasks {
+      std::int8_t high[3][16] { };
+      std::int8_t low[3][16]  { };
+      std::int8_t gap[3][16]  { };
+    };
+
+    constexpr SpacedHexMasks makeSpacedHexMasks() {
+      SpacedHexMasks masks { };
+
+      for (int block { 0 }; block < 3; ++block) {
+        for (int lane { 0 }; lane < 16; ++lane) {
+          const int at     { 16 * block + lane };
+          const int source { at / 3 };
+
+          masks.high[block][lane] = static_cast<std::int8_t>(at % 3 == 0 ? source : -1);
+          masks.low[block][lane]  = static_cast<std::int8_t>(at % 3 == 1 ? source : -1);
+          masks.gap[block][lane]  = static_cast<std::int8_t>(at % 3 == 2 ? -1 : 0);
+        }
+      }
+
+      return masks;
+    }
+
+    constexpr SpacedHexMasks spacedHexMasks { makeSpacedHexMasks() };
+
+    __attribute__((target("ssse3")))
+    __m128i loadMask(const std::int8_t* mask) {
+      return _mm_loadu_si128(reinterpret_cast<const __m128i*>(mask));
+    }
+
+    // Hex digits of 16 bytes at a time; returns how many bytes were done
+    __attribute__((target("ssse3")))
+    std::size_t hexBytesSsse3(const std::uint8_t* bytes, std::size_t n, const Options& options, char*& out) {
+      const __m128i digits    { options.upperCase ? _mm_setr_epi8('0', '1', '2', '3', '4', '5', '6', '7', '8', '9', 'A', 'B', 'C', 'D', 'E', 'F')
+                                                  : _mm_setr_epi8('0', '1', '2', '3', '4', '5', '6', '7', '8', '9', 'a', 'b', 'c', 'd', 'e', 'f') };
+      const __m128i lowNibble { _mm_set1_epi8(0x0F) };
+      const __m128i separator { _mm_set1_epi8(options.separator) };
+      std::size_t i { 0 };
+
+      for (; i + 16 <= n; i += 16) {
+        const __m128i v    { _mm_loadu_si128(reinterpret_cast<const __m128i*>(bytes + i)) };
+        const __m128i high { _mm_shuffle_epi8(digits, _mm_and_si128(_mm_srli_epi16(v, 4), lowNibble)) };
+        const __m128i low  { _mm_shuffle_epi8(digits, _mm_and_si128(v, lowNibble)) };
+
+        if (!options.separator) {
+          _mm_storeu_si128(reinterpret_cast<__m128i*>(out),      _mm_unpacklo_epi8(high, low));
+          _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 16), _mm_unpackhi_epi8(high, low));
+          out += 32;
+          continue;
+        }
+
+        for (int block { 0 }; block < 3; ++block) {
+          const __m128i text { _mm_or_si128(_mm_or_si128(_mm_shuffle_epi8(high, loadMask(spacedHexMasks.high[block])),
+                                                         _mm_shuffle_epi8(low,  loadMask(spacedHexMasks.low[block]))),
+                                            _mm_and_si128(separator, loadMask(spacedHexMasks.gap[block]))) };
+
+          _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 16 * block), text);
+        }
+
+        out += 48;
+      }
+
+      return i;
+    }
+
+    // Binary digits of 16 bytes at a time; returns how many bytes were done
+    __attribute__((target("ssse3")))
+    std::size_t binaryBytesSsse3(const std::uint8_t* bytes, std::size_t n, const Options& options, char*& out) {
+      const __m128i bitMask { _mm_setr_epi8(char(0x80), 0x40, 0x20, 0x10, 0x08, 0x04, 0x02, 0x01,
+                                            char(0x80), 0x40, 0x20, 0x10, 0x08, 0x04, 0x02, 0x01) };
+      const __m128i zeros   { _mm_set1_epi8('0') };
+      std::size_t i { 0 };
+
+      for (; i + 16 <= n; i += 16) {
+        const __m128i v { _mm_loadu_si128(reinterpret_cast<const __m128i*>(bytes + i)) };
+
+        for (int pair { 0 }; pair < 8; ++pair) {
+          // Bytes 2 * pair and 2 * pair + 1, each in 8 lanes
+          const __m128i spread { _mm_shuffle_epi8(v, _mm_setr_epi8(
+            static_cast<char>(2 * pair),     static_cast<char>(2 * pair),     static_cast<char>(2 * pair),     static_cast<char>(2 * pair),
+            static_cast<char>(2 * pair),     static_cast<char>(2 * pair),     static_cast<char>(2 * pair),     static_cast<char>(2 * pair),
+            static_cast<char>(2 * pair + 1), static_cast<char>(2 * pair + 1), static_cast<char>(2 * pair + 1), static_cast<char>(2 * pair + 1),
+            static_cast<char>(2 * pair + 1), static_cast<char>(2 * pair + 1), static_cast<char>(2 * pair + 1), static_cast<char>(2 * pair + 1))) };
+
+          // A set bit compares equal to its mask (-1), and '0' - -1 is '1'
+          const __m128i text { _mm_sub_epi8(zeros, _mm_cmpeq_epi8(_mm_and_si128(spread, bitMask), bitMask)) };
+
+          if (!options.separator) {
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out), text);
+            out += 16;
+            continue;
+          }
+
+          _mm_storel_epi64(reinterpret_cast<__m128i*>(out), text);
+          out[8] = options.separator;
+          _mm_storel_epi64(reinterpret_cast<__m128i*>(out + 9), _mm_srli_si128(text, 8));
+          out[17] = options.separator;
+          out += 18;
+        }
+      }
+
+      return i;
+    }
+#endif
+  }
+
+  std::size_t bulkCapacity(std::size_t count, std::size_t valueBytes, const Options& options) {
+    const auto digits { static_cast<std::size_t>(digitsFor(8 * static_cast<int>(valueBytes), options.radix)) };
+    const std::size_t groups { options.group > 0 ? (digits - 1) / static_cast<std::size_t>(options.group) : 0 };
+
+    return count * (prefixLength(options) + digits + groups + (options.separator ? 1 : 0));
+  }
+
+  char* write(char* out, std::uint64_t value, const Options& options, int valueBits) {
+    return writeValue(out, value, valueBits, options);
+  }
+
+  std::size_t writeBytes(std::span<const std::uint8_t> bytes, const Options& options, char* out) {
+    // A dump shows every digit of every byte
+    Options fixed { options };
+    fixed.fixedWidth = true;
+
+    char* p { out };
+    std::size_t done { 0 };
+
+#ifdef RADIX_X86
+    static const bool ssse3 { static_cast<bool>(__builtin_cpu_supports("ssse3")) };
+    const bool plain { !fixed.prefix && (fixed.group <= 0 || fixed.group >= digitsFor(8, fixed.radix)) };
+
+    if (ssse3 && plain && fixed.radix == Radix::hex)
+      done = hexBytesSsse3(bytes.data(), bytes.size(), fixed, p);
+    else if (ssse3 && plain && fixed.radix == Radix::binary)
+      done = binaryBytesSsse3(bytes.data(), bytes.size(), fixed, p);
+#endif
+
+    return static_cast<std::size_t>(p - out) + writeGeneric(bytes.subspan(done), fixed, p);
+  }
+
+  std::size_t writeAll(std::span<const std::uint32_t> values, const Options& options, char* out) {
+    return writeGeneric(values, options, out);
+  }
+
+  std::size_t writeAll(std::span<const std::uint64_t> values, const Options& options, char* out) {
+    return writeGeneric(values, options, out);
+  }
+}
@@ -0,0 +1,69 @@
+// +--------------------------------------------+
+// |      BULK HEX / OCTAL / BINARY DUMPS       |
+// +--------------------------------------------+
+//
+// std::hex, std::bitset<8> and std::format("{:b}") print one value at a
+// time. Dumping a large buffer that way spends most of its time in the
+// stream machinery. This writes whole arrays straight into a char buffer:
+//
+//   - Bytes to hex: SSSE3 looks up 16 high and 16 low nibbles at once in
+//     a "0123456789abcdef" register (pshufb), and further shuffles lay the
+//     digits out with the separators in between.
+//   - Bytes to binary: each byte is broadcast to 8 lanes and ANDed with
+//     0x80, 0x40, ..., 0x01, so a compare turns every bit into '0' or '1'.
+//   - Wider integers use SWAR bit-spread tricks in a 64-bit register: one
+//     nibble (or bit) per byte, then '0' is added to all 8 at once.
+//   - Octal digits are 3 bits, which do not line up with bytes, so they
+//     are written one at a time.
+//
+// Options add a prefix (0x, 0b or 0), digit groups (1100'0101) and
+// uppercase hex. Bytes always get their full width (2, 3 or 8 digits), as
+// in a dump. Other values get it only when asked for.
+
+#pragma once
+
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+
+namespace RadixFormat {
+  enum class Radix { binary = 2, octal = 8, hex = 16 };
+
+  struct Options {
+    Radix radix          { Radix::hex };
+    bool  prefix         { false };  // 0x, 0b or 0
+    bool  fixedWidth     { false };  // every digit of the type, e.g. 000000ff for a uint32
+    bool  upperCase      { false };
+    int   group          { 0 };      // groupSeparator every `group` digits from the right; 0 for none
+    char  groupSeparator { '\'' };
+    char  separator      { ' ' };    // after every value; '\0' for none
+  };
+
+  // Bytes needed to format `count` values of `valueBytes` bytes each
+  std::size_t bulkCapacity(std::size_t count, std::size_t valueBytes, const Options& options);
+
+  // One value, written at out (bulkCapacity(1, sizeof(value), options)
+  // bytes), without the separator; returns one past the last character
+  char* write(char* out, std::uint64_t value, const Options& options, int valueBits = 64);
+
+  // Every value followed by the separator, into out (bulkCapacity bytes);
+  // returns the number of bytes written
+  std::size_t writeBytes(std::span<const std::uint8_t>  bytes,  const Options& options, char* out);
+  std::size_t writeAll  (std::span<const std::uint32_t> values, const Options& options, char* out);
+  std::size_t writeAll  (std::span<const std::uint64_t> values, const Options& options, char* out);
+
+  // Same, appended to a string
+  template <typename T>
+    requires std::same_as<T, std::uint8_t> || std::same_as<T, std::uint32_t> || std::same_as<T, std::uint64_t>
+  void appendAll(std::span<const T> values, const Options& options, std::string& out) {
+    const std::size_t used { out.size() };
+    out.resize(used + bulkCapacity(values.size(), sizeof(T), options));
+
+    if constexpr (std::same_as<T, std::uint8_t>)
+      out.resize(used + writeBytes(values, options, out.data() + used));
+    else
+      out.resize(used + writeAll(values, options, out.data() + used));
+  }
+}
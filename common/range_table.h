@@ -0,0 +1,110 @@
+// +--------------------------------------------+
+// |     COMPILE-TIME RANGE -> VALUE TABLES     |
+// +--------------------------------------------+
+//
+// Functions like getQuantityPhrase map small integers to strings with an
+// if/else chain: one compare and branch per rule, and a misprediction
+// whenever the input changes rule unpredictably. This turns the same rules,
+// written as data, into a dense array built at compile time:
+//
+//   constexpr RangeTable::Rule<std::string_view> rules[] {
+//     { 0, 0,                     "no"   },
+//     { 1, 3,                     "some" },
+//     { 4, RangeTable::unbounded, "many" },
+//   };
+//   constexpr auto phrases { RangeTable::make<RangeTable::denseSize(rules)>(rules) };
+//
+//   phrases[n]   // one clamp (cmov) and one load, no branch on n
+//
+// The table has an entry for every key up to the start of the last,
+// unbounded rule; larger keys are clamped onto that entry. make() is
+// consteval and rejects rules that overlap, leave a gap (without a
+// fallback), or do not end in one unbounded rule, so mistakes are compile
+// errors. Signed keys are looked up as their unsigned value, which puts
+// negative numbers past the end, on the unbounded rule.
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <type_traits>
+
+namespace RangeTable {
+  inline constexpr std::uint64_t unbounded { std::numeric_limits<std::uint64_t>::max() };
+
+  // Keys first..last (inclusive) map to value
+  template <typename Value>
+  struct Rule {
+    std::uint64_t first;
+    std::uint64_t last;
+    Value         value;
+  };
+
+  template <typename Value, std::size_t Size>
+  class Table {
+  public:
+    static_assert(Size > 0);
+
+    constexpr explicit Table(const std::array<Value, Size>& values) : m_values { values } { }
+
+    constexpr const Value& operator[](std::uint64_t key) const {
+      return m_values[key < Size - 1 ? key : Size - 1];
+    }
+
+  private:
+    std::array<Value, Size> m_values;
+  };
+
+  // Entries make() needs: one per key below the unbounded rule's first,
+  // plus one for it
+  template <typename Value, std::size_t N>
+  consteval std::size_t denseSize(const Rule<Value> (&rules)[N]) {
+    for (const Rule<Value>& rule : rules)
+      if (rule.last == unbounded)
+        return static_cast<std::size_t>(rule.first) + 1;
+
+    throw "RangeTable: no rule runs to unbounded";
+  }
+
+  // Keys no rule covers get `fallback`; without one, every key must be
+  // covered exactly once
+  template <std::size_t Size, typename Value, std::size_t N>
+  consteval Table<Value, Size> make(const Rule<Value> (&rules)[N], std::optional<std::type_identity_t<Value>> fallback = std::nullopt) {
+    std::array<Value, Size> values { };
+    std::array<bool, Size>  covered { };
+
+    for (const Rule<Value>& rule : rules) {
+      if (rule.first > rule.last)
+        throw "RangeTable: rule with first > last";
+
+      if (rule.last == unbounded && rule.first != Size - 1)
+        throw "RangeTable: the unbounded rule must start at Size - 1";
+
+      if (rule.last != unbounded && rule.last >= Size - 1)
+        throw "RangeTable: a bounded rule reaches into the clamped entry";
+
+      for (std::uint64_t key { rule.first }; key <= rule.last && key < Size; ++key) {
+        if (covered[key])
+          throw "RangeTable: overlapping rules";
+
+        values[key]  = rule.value;
+        covered[key] = true;
+      }
+    }
+
+    for (std::size_t key { 0 }; key < Size; ++key) {
+      if (covered[key])
+        continue;
+
+      if (!fallback)
+        throw "RangeTable: a key is covered by no rule and there is no fallback";
+
+      values[key] = *fallback;
+    }
+
+    return Table<Value, Size> { values };
+  }
+}
@@ -0,0 +1,321 @@
+#include "utf8.h"
+
+#include <array>
+#include <cstdint>
+
+#if defined(__x86_64__) || defined(__i386__)
+  #include <immintrin.h>
+  #define UTF8_X86 1
+#endif
+
+namespace Utf8 {
+  namespace {
+    // Where a sequence is, after the bytes seen so far. The restricted
+    // first continuation bytes after E0, ED, F0 and F4 (Unicode table 3-7)
+    // each get a state of their own.
+    enum State : std::uint8_t { accept, need1, need2, need3, afterE0, afterED, afterF0, afterF4, reject, stateCount };
+
+    constexpr bool isContinuation(unsigned b) { return (b & 0xC0) == 0x80; }
+
+    constexpr State step(State state, unsigned b) {
+      switch (state) {
+        case accept:
+          if (b < 0x80)                return accept;
+          if (b >= 0xC2 && b <= 0xDF)  return need1;
+          if (b == 0xE0)               return afterE0;
+          if (b == 0xED)               return afterED;
+          if (b >= 0xE1 && b <= 0xEF)  return need2;
+          if (b == 0xF0)               return afterF0;
+          if (b >= 0xF1 && b <= 0xF3)  return need3;
+          if (b == 0xF4)               return afterF4;
+          return reject;
+
+        case need1:   return isContinuation(b) ? accept : reject;
+        case need2:   return isContinuation(b) ? need1  : reject;
+        case need3:   return isContinuation(b) ? need2  : reject;
+        case afterE0: return b >= 0xA0 && b <= 0xBF ? need1 : reject; // no overlong 3-byte forms
+        case afterED: return b >= 0x80 && b <= 0x9F ? need1 : reject; // no surrogates
+        case afterF0: return b >= 0x90 && b <= 0xBF ? need2 : reject; // no overlong 4-byte forms
+        case afterF4: return b >= 0x80 && b <= 0x8F ? need2 : reject; // nothing past U+10FFFF
+        default:      return reject;
+      }
+    }
+
+    using Transitions = std::array<std::array<State, 256>, stateCount>;
+
+    constexpr Transitions makeTransitions() {
+      Transitions table { };
+
+      for (int s { 0 }; s < stateCount; ++s)
+        for (unsigned b { 0 }; b < 256; ++b)
+          table[static_cast<std::size_t>(s)][b] = step(static_cast<State>(s), b);
+
+      return table;
+    }
+
+    constexpr Transitions transitions { makeTransitions() };
+
+    const std::uint8_t* bytesOf(std::string_view text) {
+      return reinterpret_cast<const std::uint8_t*>(text.data());
+    }
+
+    std::size_t scanScalar(const std::uint8_t* s, std::size_t begin, std::size_t n) {
+      State state { accept };
+      std::size_t start { begin };
+
+      for (std::size_t i { begin }; i < n; ++i) {
+        if (state == accept)
+          start = i;
+
+        state = transitions[state][s[i]];
+
+        if (state == reject)
+          return start;
+      }
+
+      return state == accept ? npos : start;
+    }
+
+    // Start of the character that straddles position i, if one does
+    std::size_t restartBefore(const std::uint8_t* s, std::size_t i) {
+      for (std::size_t back { 1 }; back <= 3 && back <= i; ++back) {
+        const std::uint8_t b { s[i - back] };
+
+        if (b >= 0xC0)
+          return i - back;
+
+        if (b < 0x80)
+          break;
+      }
+
+      return i;
+    }
+
+#ifdef UTF8_X86
+    // Error flags for a byte pair (previous byte, this byte); a pair is bad
+    // when all three lookups agree on some flag
+    constexpr std::uint8_t tooShort    { 1 << 0 }; // 11______ 0_______  or  11______ 11______
+    constexpr std::uint8_t tooLong     { 1 << 1 }; // 0_______ 10______
+    constexpr std::uint8_t overlong3   { 1 << 2 }; // 11100000 100_____
+    constexpr std::uint8_t tooLarge    { 1 << 3 }; // 11110100 1001____ and above
+    constexpr std::uint8_t surrogate   { 1 << 4 }; // 11101101 101_____
+    constexpr std::uint8_t overlong2   { 1 << 5 }; // 1100000_ 10______
+    constexpr std::uint8_t tooLarge1000 { 1 << 6 }; // 11110101 1000____ and above
+    constexpr std::uint8_t overlong4   { 1 << 6 }; // 11110000 1000____
+    constexpr std::uint8_t twoConts    { 1 << 7 }; // 10______ 10______
+    constexpr std::uint8_t carry       { tooShort | tooLong | twoConts };
+
+    __attribute__((target("ssse3")))
+    __m128i table16(std::uint8_t a0, std::uint8_t a1, std::uint8_t a2, std::uint8_t a3,
+                    std::uint8_t a4, std::uint8_t a5, std::uint8_t a6, std::uint8_t a7,
+                    std::uint8_t a8, std::uint8_t a9, std::uint8_t a10, std::uint8_t a11,
+                    std::uint8_t a12, std::uint8_t a13, std::uint8_t a14, std::uint8_t a15) {
+      return _mm_setr_epi8(static_cast<char>(a0),  static_cast<char>(a1),  static_cast<char>(a2),  static_cast<char>(a3),
+                           static_cast<char>(a4),  static_cast<char>(a5),  static_cast<char>(a6),  static_cast<char>(a7),
+                           static_cast<char>(a8),  static_cast<char>(a9),  static_cast<char>(a10), static_cast<char>(a11),
+                           static_cast<char>(a12), static_cast<char>(a13), static_cast<char>(a14), static_cast<char>(a15));
+    }
+
+    __attribute__((target("ssse3")))
+    __m128i highNibbles(__m128i v) {
+      return _mm_and_si128(_mm_srli_epi16(v, 4), _mm_set1_epi8(0x0F));
+    }
+
+    __attribute__((target("ssse3")))
+    std::size_t firstInvalidSsse3(const std::uint8_t* s, std::size_t n) {
+      const __m128i byte1High { table16(
+        tooLong, tooLong, tooLong, tooLong, tooLong, tooLong, tooLong, tooLong, // 0_______
+        twoConts, twoConts, twoConts, twoConts,                                 // 10______
+        tooShort | overlong2,                                                   // 1100____
+        tooShort,                                                               // 1101____
+        tooShort | overlong3 | surrogate,                                       // 1110____
+        tooShort | tooLarge | tooLarge1000 | overlong4) };                      // 1111____
+
+      const __m128i byte1Low { table16(
+        carry | overlong3 | overlong2 | overlong4,                              // ____0000
+        carry | overlong2,                                                      // ____0001
+        carry, carry,                                                           // ____001_
+        carry | tooLarge,                                                       // ____0100
+        carry | tooLarge | tooLarge1000, carry | tooLarge | tooLarge1000,       // ____0101, ____0110
+        carry | tooLarge | tooLarge1000, carry | tooLarge | tooLarge1000,       // ____0111, ____1000
+        carry | tooLarge | tooLarge1000, carry | tooLarge | tooLarge1000,
+        carry | tooLarge | tooLarge1000, carry | tooLarge | tooLarge1000,
+        carry | tooLarge | tooLarge1000 | surrogate,                            // ____1101
+        carry | tooLarge | tooLarge1000, carry | tooLarge | tooLarge1000) };
+
+      const __m128i byte2High { table16(
+        tooShort, tooShort, tooShort, tooShort, tooShort, tooShort, tooShort, tooShort, // ________ 0_______
+        tooLong | overlong2 | twoConts | overlong3 | tooLarge1000 | overlong4,          // ________ 1000____
+        tooLong | overlong2 | twoConts | overlong3 | tooLarge,                          // ________ 1001____
+        tooLong | overlong2 | twoConts | surrogate | tooLarge,                          // ________ 101_____
+        tooLong | overlong2 | twoConts | surrogate | tooLarge,
+        tooShort, tooShort, tooShort, tooShort) };                                      // ________ 11______
+
+      // A block ending in these still owes continuation bytes to the next
+      const __m128i incompleteLimit { table16(0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+                                              0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xF0 - 1, 0xE0 - 1, 0xC0 - 1) };
+
+      __m128i previous   { _mm_setzero_si128() };
+      __m128i incomplete { _mm_setzero_si128() };
+      std::size_t i { 0 };
+
+      auto failed { [](__m128i flags) { return _mm_movemask_epi8(_mm_cmpeq_epi8(flags, _mm_setzero_si128())) != 0xFFFF; } };
+
+      while (i + 16 <= n) {
+        // Plain ASCII: only an unfinished sequence before it can be wrong
+        if (i + 64 <= n) {
+          const __m128i a { _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + i)) };
+          const __m128i b { _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + i + 16)) };
+          const __m128i c { _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + i + 32)) };
+          const __m128i d { _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + i + 48)) };
+
+          if (_mm_movemask_epi8(_mm_or_si128(_mm_or_si128(a, b), _mm_or_si128(c, d))) == 0) {
+            if (failed(incomplete))
+              return scanScalar(s, restartBefore(s, i), n);
+
+            previous = d;
+            i += 64;
+            continue;
+          }
+        }
+
+        const __m128i input { _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + i)) };
+
+        if (_mm_movemask_epi8(input) == 0) {
+          if (failed(incomplete))
+            return scanScalar(s, restartBefore(s, i), n);
+
+          previous = input;
+          i += 16;
+          continue;
+        }
+
+        const __m128i prev1 { _mm_alignr_epi8(input, previous, 15) };
+        const __m128i pairs { _mm_and_si128(_mm_and_si128(_mm_shuffle_epi8(byte1High, highNibbles(prev1)),
+                                                          _mm_shuffle_epi8(byte1Low, _mm_and_si128(prev1, _mm_set1_epi8(0x0F)))),
+                                            _mm_shuffle_epi8(byte2High, highNibbles(input))) };
+
+        // Third and fourth bytes of a sequence must be continuations too
+        const __m128i third  { _mm_subs_epu8(_mm_alignr_epi8(input, previous, 14), _mm_set1_epi8(static_cast<char>(0xE0 - 0x80))) };
+        const __m128i fourth { _mm_subs_epu8(_mm_alignr_epi8(input, previous, 13), _mm_set1_epi8(static_cast<char>(0xF0 - 0x80))) };
+        const __m128i mustBeContinuation { _mm_and_si128(_mm_or_si128(third, fourth), _mm_set1_epi8(static_cast<char>(0x80))) };
+
+        if (failed(_mm_xor_si128(mustBeContinuation, pairs)))
+          return scanScalar(s, restartBefore(s, i), n);
+
+        incomplete = _mm_subs_epu8(input, incompleteLimit);
+        previous   = input;
+        i += 16;
+      }
+
+      return scanScalar(s, restartBefore(s, i), n);
+    }
+#endif
+  }
+
+  std::size_t firstInvalidScalar(std::string_view text) {
+    return scanScalar(bytesOf(text), 0, text.size());
+  }
+
+  std::size_t firstInvalid(std::string_view text) {
+#ifdef UTF8_X86
+    static const bool ssse3 { static_cast<bool>(__builtin_cpu_supports("ssse3")) };
+
+    if (ssse3)
+      return firstInvalidSsse3(bytesOf(text), text.size());
+#endif
+
+    return firstInvalidScalar(text);
+  }
+
+  std::size_t countCodePoints(std::string_view text) {
+    const std::uint8_t* s { bytesOf(text) };
+    const std::size_t n { text.size() };
+    std::size_t count { 0 }, i { 0 };
+
+#ifdef UTF8_X86
+    // Signed, continuation bytes 0x80..0xBF are the only ones below -64
+    const __m128i limit { _mm_set1_epi8(-65) };
+
+    for (; i + 16 <= n; i += 16) {
+      const __m128i v { _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + i)) };
+      count += static_cast<std::size_t>(__builtin_popcount(static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpgt_epi8(v, limit)))));
+    }
+#endif
+
+    for (; i < n; ++i)
+      count += !isContinuation(s[i]);
+
+    return count;
+  }
+
+  std::size_t decode(std::string_view text, char32_t* out) {
+    const std::uint8_t* s { bytesOf(text) };
+    const std::size_t n { text.size() };
+    char32_t* start { out };
+    std::size_t i { 0 };
+
+    while (i < n) {
+#ifdef UTF8_X86
+      // ASCII widens 16 bytes to 16 code points. A block that is only partly
+      // ASCII is widened anyway and kept up to its first multibyte sequence;
+      // out never runs ahead of i, so the extra stores stay in bounds.
+      while (i + 16 <= n) {
+        const __m128i v { _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + i)) };
+        const auto mask { static_cast<unsigned>(_mm_movemask_epi8(v)) };
+        const std::size_t ascii { mask == 0 ? 16u : static_cast<std::size_t>(__builtin_ctz(mask)) };
+
+        if (ascii == 0)
+          break;
+
+        const __m128i zero { _mm_setzero_si128() };
+        const __m128i low  { _mm_unpacklo_epi8(v, zero) };
+        const __m128i high { _mm_unpackhi_epi8(v, zero) };
+
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out),      _mm_unpacklo_epi16(low, zero));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 4),  _mm_unpackhi_epi16(low, zero));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 8),  _mm_unpacklo_epi16(high, zero));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 12), _mm_unpackhi_epi16(high, zero));
+        out += ascii;
+        i   += ascii;
+
+        if (ascii < 16)
+          break;
+      }
+
+      if (i == n)
+        break;
+#endif
+
+      const std::uint8_t lead { s[i] };
+
+      if (lead < 0x80) {
+        *out++ = lead;
+        ++i;
+        continue;
+      }
+
+      State state { transitions[accept][lead] };
+      const std::size_t length { lead < 0xE0 ? 2u : lead < 0xF0 ? 3u : 4u };
+
+      if (state == reject || i + length > n)
+        return npos;
+
+      char32_t codePoint { static_cast<char32_t>(lead & (0x7F >> length)) };
+
+      for (std::size_t k { 1 }; k < length; ++k) {
+        state = transitions[state][s[i + k]];
+
+        if (state == reject)
+          return npos;
+
+        codePoint = codePoint << 6 | (s[i + k] & 0x3F);
+      }
+
+      *out++ = codePoint;
+      i += length;
+    }
+
+    return static_cast<std::size_t>(out - start);
+  }
+}
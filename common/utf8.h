@@ -0,0 +1,47 @@
+// +--------------------------------------------+
+// |        UTF-8 VALIDATION AND DECODING       |
+// +--------------------------------------------+
+//
+// Names and other text typed into the quiz programs are just bytes. This
+// checks that they are well-formed UTF-8 (no overlong forms, surrogates,
+// stray continuation bytes or code points past U+10FFFF) fast enough to
+// run over every input chunk:
+//
+//   - Pure ASCII is confirmed 64 bytes at a time with one movemask.
+//   - Everything else uses the Keiser-Lemire lookup method with SSSE3:
+//     three 16-entry pshufb tables, indexed by the high and low nibble of
+//     each byte and the high nibble of the byte after it, flag every
+//     error that two adjacent bytes can show. One more check catches
+//     missing or surplus continuation bytes two and three positions on.
+//   - A block that fails is rescanned with the scalar state machine, which
+//     says exactly where the bad sequence starts.
+//
+// Counting code points only counts bytes that are not 10xxxxxx, 16 at a
+// time. Decoding widens ASCII runs 16 bytes at a time and decodes the
+// rest one sequence at a time.
+
+#pragma once
+
+#include <cstddef>
+#include <string_view>
+
+namespace Utf8 {
+  inline constexpr std::size_t npos { std::string_view::npos };
+
+  // Offset of the first byte of the first invalid (or truncated)
+  // sequence, or npos if all of `text` is valid
+  std::size_t firstInvalid(std::string_view text);
+
+  inline bool validate(std::string_view text) { return firstInvalid(text) == npos; }
+
+  // Byte-at-a-time state machine: the reference, and the baseline the
+  // vector path is measured against
+  std::size_t firstInvalidScalar(std::string_view text);
+
+  // Code points in valid UTF-8 (the result is meaningless otherwise)
+  std::size_t countCodePoints(std::string_view text);
+
+  // Decodes `text` into out (room for text.size() code points). Returns the
+  // number of code points, or npos if `text` is not valid UTF-8.
+  std::size_t decode(std::string_view text, char32_t* out);
+}